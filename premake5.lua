@@ -27,28 +27,24 @@ download_file("src/tinycthread.h", "https://raw.githubusercontent.com/tinycthrea
 download_file("src/stb_image.h", "https://raw.githubusercontent.com/nothings/stb/refs/heads/master/stb_image.h")
 download_file("src/stb_image_write.h", "https://raw.githubusercontent.com/nothings/stb/refs/heads/master/stb_image_write.h")
 
+-- options
+newoption {
+    trigger     = "no-builtins",
+    description = "Don't build the configurations in resources/ into Tilize (needed when cross compiling, as generating them runs TilizeEmbed)"
+}
+
 -- premake configuration
 workspace "Tilize"
     configurations { "Debug", "Release" }
     platforms { "NoSDL", "SDL" }
 
-project "Tilize"
-    kind "ConsoleApp"
     language "C"
     cdialect "C11"
     targetdir "bin/%{cfg.buildcfg}_%{cfg.platform}"
 
-    files { "src/**.h", "src/**.c" }
-
     strictaliasing "Off"
     warnings "Extra"
 
-    postbuildcommands {
-        "{COPYDIR} resources/ %{cfg.buildtarget.directory}/",
-        "{COPYFILE} LICENSE %{cfg.buildtarget.directory}/MIT_License.txt",
-        "{COPYFILE} for_users.md %{cfg.buildtarget.directory}/README.md",
-    }
-
     filter "configurations:Debug"
         defines { "DEBUG=1" }
         symbols "On"
@@ -57,6 +53,88 @@ project "Tilize"
         defines { "NDEBUG=1" }
         optimize "On"
 
+    filter "toolset:gcc or toolset:clang"
+        buildoptions { "-Wpedantic", "-Werror" }
+
+    filter {}
+
+-- everything needed to tilize images, without any of the command line or gui stuff
+project "libtilize"
+    kind "StaticLib"
+    targetname "tilize"
+
+    files {
+        "src/atlas.h",         "src/atlas.c",
+        "src/configuration.h", "src/configuration.c",
+        "src/load_png.h",      "src/load_png.c",
+        "src/map_file.h",      "src/map_file.c",
+        "src/netpbm.h",        "src/netpbm.c",
+        "src/print.h",         "src/print.c",
+        "src/qoi.h",           "src/qoi.c",
+        "src/rgb24.h",
+        "src/search.h",        "src/search.c",
+        "src/texture.h",       "src/texture.c",
+        "src/thread_pool.h",   "src/thread_pool.c",
+        "src/timing.h",        "src/timing.c",
+        "src/tilize.h",        "src/tilize.c",
+        "src/cJSON.h",         "src/cJSON.c",
+        "src/tinycthread.h",   "src/tinycthread.c",
+        "src/stb_image.h",     "src/stb_image.c",
+        "src/stb_image_write.h", "src/stb_image_write.c",
+    }
+
+-- turns the configurations in resources/ into src/builtin_configs.c
+project "TilizeEmbed"
+    kind "ConsoleApp"
+
+    files {
+        "tools/embed.c",
+    }
+    includedirs { "src" }
+
+    links { "libtilize" }
+
+    filter "system:not windows"
+        links { "m" }
+
+    filter {}
+
+-- the command line application
+project "Tilize"
+    kind "ConsoleApp"
+
+    files {
+        "src/main.c",
+        "src/application.h", "src/application.c",
+        "src/cache.h",       "src/cache.c",
+        "src/checkpoint.h",  "src/checkpoint.c",
+        "src/get_threads.h", "src/get_threads.c",
+        "src/gui.h",         "src/gui.c",
+        "src/region.h",      "src/region.c",
+        "src/serve.h",       "src/serve.c",
+        "src/shard.h",       "src/shard.c",
+        "src/sweep.h",       "src/sweep.c",
+        "src/watch.h",       "src/watch.c",
+    }
+
+    links { "libtilize" }
+
+    if _OPTIONS["no-builtins"] then
+        defines { "BUILTIN_CONFIGS_SUPPORTED=0" }
+    else
+        files { "src/builtin_configs.h", "src/builtin_configs.c" }
+        dependson { "TilizeEmbed" }
+        prebuildcommands {
+            "\"%{cfg.buildtarget.directory}/TilizeEmbed\" src/builtin_configs.c " .. table.concat(os.matchfiles("resources/*.json"), " "),
+        }
+    end
+
+    postbuildcommands {
+        "{COPYDIR} resources/ %{cfg.buildtarget.directory}/",
+        "{COPYFILE} LICENSE %{cfg.buildtarget.directory}/MIT_License.txt",
+        "{COPYFILE} for_users.md %{cfg.buildtarget.directory}/README.md",
+    }
+
     filter "platforms:NoSDL"
         defines { "GUI_SUPPORTED=0" }
 
@@ -66,8 +144,5 @@ project "Tilize"
         libdirs { os.findlib("SDL2") }
         links { "SDL2" }
 
-    filter "toolset:gcc or toolset:clang"
-        buildoptions { "-Wpedantic", "-Werror" }
-
     filter "system:not windows"
         links { "m" }
@@ -33,344 +33,344 @@
 
 #include "application.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <limits.h>
+#include <signal.h>
 #include <stdatomic.h>
-#include "atlas.h"
+#include "cache.h"
+#include "checkpoint.h"
 #include "configuration.h"
 #include "gui.h"
 #include "load_png.h"
 #include "print.h"
+#include "region.h"
+#include "shard.h"
 #include "texture.h"
+#include "thread_pool.h"
+#include "tilize.h"
 #include "tinycthread.h"
-#if GUI_SUPPORTED
-    #include <SDL2/SDL.h>
-#endif
-
-// try to present to gui every ... itterations of the loop (to speed up stuff obv)
-#define PRESENT_ITERATIONS 16
 
-// all data needed by a thread running the application
-struct app_thread_data{
-    int ct_min, ct_max; // minimum and maximum (exclusive) tile indecies computed by thread
-    rgb24_atlas_t *input_atlas;
-    atomic_int *running;
-    #if GUI_SUPPORTED
-        int check_sdl;
-    #endif
+// all data needed by the thread running tilize_process() while the gui is shown
+struct app_runner_data{
+    const rgb24_texture_t          *input_texture;
+    rgb24_texture_t                *output_texture;
+    const tilize_process_options_t *options;
+    atomic_int                     *threads_left;
+    int                             ret_code;
 };
 
 // data currently operated on
-static int            num_threads;
-static int            num_colors;
-static rgb24_t       *colors;
-static rgb24_atlas_t  pattern_atlas;
-static int            col1_min,
-                      col1_max,
-                      col2_min,
-                      col2_max;
-static const char    *output_file;
+static tilize_context_t *context;
+static int               num_threads;
+static thread_pool_t    *pool;
+static const char       *output_file,
+                        *output_format;
+static int               deadline_ms,
+                         quality,
+                         shard_index,
+                         shard_count,
+                         checkpoint_s,
+                         resume;
+static char             *checkpoint_path;
+static const char       *previous_path,
+                        *old_input_path,
+                        *dirty_rects,
+                        *tile_map_path,
+                        *roi,
+                        *mask_path,
+                        *cache_dir;
+static int               cache_mib;
+static char              cache_key_str[CACHE_KEY_LENGTH + 1]; // empty unless the result should be stored in the cache
+static atomic_int        running; // cleared to cancel tilizing
+static volatile sig_atomic_t stop_requested; // set if tilizing was cancelled by SIGINT or SIGTERM
 #if GUI_SUPPORTED
-    static int        show_gui;
+    static int           show_gui;
 #endif
 
-// performs the loop that does the thing
-static int process_loop(void *input_data_void);
-// gets difference between a pattern with specific colors and an rgb24_t array
-static unsigned long get_difference(const rgb24_t *restrict data, int pattern_index, int col1, int col2);
+// sets stop_requested and clears running
+static void handle_stop_signal(int signal_number);
+#if GUI_SUPPORTED
+    // renders a finished tile to the gui
+    static void render_tile(void *user_data, int tile_x, int tile_y, const rgb24_texture_t *tile);
+    // runs tilize_process() off the gui thread
+    static int process_runner(void *runner_data_void);
+#endif
 
 // sets up application with the provided configs
-int application_setup(const tilize_config_t *restrict tilize_config, const flag_config_t *restrict flag_config){
-    // load pattern texture
-    rgb24_texture_t pattern_texture = RGB24_TEXTURE_NULL;
-    if(!(flag_config->config_path == NULL || tilize_config->pattern_path == NULL)){
-        // path provided
-        // get final pattern path
-        #define PP_LEN 255
-        char pattern_path[PP_LEN + 1] = "";
-        strncpy(pattern_path, flag_config->config_path, PP_LEN);
-        char *last_slash = strrchr(pattern_path, '/');
-        if(last_slash == NULL) last_slash = strrchr(pattern_path, '\\'); // retry with '\'
-        if(last_slash == NULL){
-            strncpy(pattern_path, tilize_config->pattern_path, PP_LEN);
-        }
-        else{
-            ++last_slash;
-            strncpy(last_slash, tilize_config->pattern_path, PP_LEN - (last_slash - pattern_path));
-        }
-        #undef PP_LEN
-
-        // load pattern as texture
-        if(load_png(&pattern_texture, pattern_path)){
-            VERRPRINT(0, "Failed to load pattern_texture");
-            return 1;
-        }
-    }
-    else{
-        // path not provided, generating at runtime
-        // is based on default tilize config defined in `main.c` in `main()`
-        if(rgb24_texture_create(&pattern_texture, 8, 4)){
-            VERRPRINT(0, "Failed to create pattern_texture");
-            return 1;
-        }
-        for(int i = 0; i < 4 * 8; ++i){ // lets just hope the compiler takes care of optimizing this
-            const int x = i % 8,
-                      y = i / 8;
-            if(x <= 1 || (x >= 4 && y <= 1)) pattern_texture.data[i] = RGB24(0xff, 0xff, 0xff);
-            else                             pattern_texture.data[i] = RGB24(0x00, 0x00, 0x00);
-        }
-    }
-
-    // split pattern_texture into pattern_atlas and clean
-    if(rgb24_atlas_from_texture(&pattern_atlas, &pattern_texture, tilize_config->tile_width, tilize_config->tile_height)){
-        VERRPRINT(0, "Failed to split pattern_texture into pattern_atlas");
-        rgb24_texture_destroy(&pattern_texture);
+// thread_pool is used for tilizing if not NULL, it has to stay around until application_free()
+int application_setup(const flag_config_t *restrict flag_config, thread_pool_t *thread_pool){
+    // load context
+    if(tilize_context_load(&context, flag_config->config_path)){
+        VERRPRINT(0, "Failed to load context");
         return 1;
     }
-    rgb24_texture_destroy(&pattern_texture);
-
-    // copy colors
-    num_colors = tilize_config->num_colors;
-    colors = malloc(num_colors * sizeof(*colors));
-    if(!colors){
-        VERRPRINT(0, "Failed to allocate colors");
-        rgb24_atlas_destroy(&pattern_atlas);
-        return 1;
-    }
-    for(int i = 0; i < num_colors; ++i){
-        colors[i] = tilize_config->colors[i];
-    }
-
-    // get bckg_color and forg_color
-    if(tilize_config->bckg_color != -1){
-        col2_min = tilize_config->bckg_color;
-        col2_max = tilize_config->bckg_color + 1;
-    }
-    else{
-        col2_min = 0;
-        col2_max = num_colors;
-    }
-    if(tilize_config->forg_color != -1){
-        col1_min = tilize_config->forg_color;
-        col1_max = tilize_config->forg_color + 1;
-    }
-    else{
-        col1_min = 0;
-        col1_max = num_colors;
-    }
 
     // misc
     num_threads = flag_config->num_threads;
     if(num_threads < 1) num_threads = 1;
-    output_file = flag_config->file_outp_path;
+    pool = thread_pool;
+    output_file   = flag_config->file_outp_path;
+    output_format = flag_config->file_outp_format;
+    deadline_ms = flag_config->deadline_ms;
+    quality     = flag_config->quality;
+    shard_index  = flag_config->shard_index;
+    shard_count  = flag_config->shard_count;
+    checkpoint_s = flag_config->checkpoint_s;
+    resume       = flag_config->resume;
+    previous_path  = flag_config->previous_path;
+    old_input_path = flag_config->old_input_path;
+    dirty_rects    = flag_config->dirty_rects;
+    tile_map_path  = flag_config->tile_map_path;
+    roi            = flag_config->roi;
+    mask_path      = flag_config->mask_path;
+    cache_mib      = flag_config->cache_mib > 0 ? flag_config->cache_mib : CACHE_DEFAULT_MIB;
+    cache_key_str[0] = 0;
+
+    // only plain runs with a result file can be cached, everything else depends on more than the input and the configuration
+    // (entries are kept by the ending of the result file, so one saved in another format or to stdout can't be either)
+    cache_dir = flag_config->cache_dir;
+    if(cache_dir && (!output_file || !strcmp(output_file, "-") || output_format || deadline_ms > 0 || shard_count > 0 || checkpoint_s > 0 || resume || previous_path || tile_map_path || roi || mask_path)){
+        VPRINT(2, "Not using the cache, the result doesn't only depend on the input and the configuration or isn't saved\n");
+        cache_dir = NULL;
+    }
     #if GUI_SUPPORTED
         show_gui = flag_config->showgui;
     #endif
 
+    // checkpoint goes next to the output
+    if(checkpoint_s > 0 || resume){
+        if(!output_file || !strcmp(output_file, "-")){
+            VPRINT(1, "Please provide where the result should be saved with `-o [file]`, the checkpoint is saved next to it\n");
+            tilize_context_destroy(context);
+            context = NULL;
+            return 1;
+        }
+        checkpoint_path = malloc(strlen(output_file) + sizeof(".checkpoint"));
+        if(!checkpoint_path){
+            VERRPRINT(0, "Failed to allocate checkpoint_path");
+            tilize_context_destroy(context);
+            context = NULL;
+            return 1;
+        }
+        strcpy(checkpoint_path, output_file);
+        strcat(checkpoint_path, ".checkpoint");
+    }
+
     return 0;
 }
 // frees everything application uses
 void application_free(void){
-    num_colors = 0;
-    if(colors) free(colors);
-    rgb24_atlas_destroy(&pattern_atlas);
+    tilize_context_destroy(context);
+    free(checkpoint_path);
+    context         = NULL;
+    pool            = NULL;
+    checkpoint_path = NULL;
 }
 
-// processes input
-int application_process(const rgb24_texture_t *restrict input_texture){
-    // split input_texture into input_atlas
-    rgb24_atlas_t input_atlas = RGB24_ATLAS_NULL;
-    if(rgb24_atlas_from_texture(&input_atlas, input_texture, pattern_atlas.tile_width, pattern_atlas.tile_height)){
-        VERRPRINT(0, "Failed to split input_texture into input_atlas");
+// looks up the result for the image file at input_path in the cache (if one is used), *hit is set to whether it was found and saved to the output
+// the image doesn't have to be decoded for this, on a hit there's nothing left to do
+int application_fetch_cached(const char *input_path, int *hit){
+    *hit = 0;
+    // stdin can only be read once, by whatever decodes the image
+    if(!cache_dir || !strcmp(input_path, "-")) return 0;
+    if(cache_key(cache_key_str, input_path, context, quality, output_file)){
+        VERRPRINTF(0, "Failed to get the cache key of %s", input_path);
+        cache_key_str[0] = 0;
         return 1;
     }
-
-    #if GUI_SUPPORTED
-        if(!show_gui) goto _post_show_prev;
-        // show previous image
-        gui_render_texture(0, 0, input_texture);
-        gui_present();
-        _post_show_prev:;
-    #endif
-
-    // do the thing
-    atomic_int running;
+    if(cache_fetch(cache_dir, cache_key_str, output_file, hit)){
+        VERRPRINTF(0, "Failed to fetch %s from the cache", input_path);
+        return 1;
+    }
+    return 0;
+}
+// processes input
+// returns 0 on success (including being cancelled through the gui), 1 on failure and 2 if cancelled by SIGINT or SIGTERM
+int application_process(const rgb24_texture_t *restrict input_texture){
     atomic_store(&running, 1);
-    thrd_t                 *process_threads = NULL;
-    struct app_thread_data *thread_data     = NULL;
-    if(num_threads > 1){
-        process_threads = malloc((num_threads - 1) * sizeof(*process_threads));
-        if(!process_threads){
-            VERRPRINT(0, "Failed to allocate process_threads");
-            goto _main_process;
+    stop_requested = 0;
+    tilize_process_options_t options = TILIZE_PROCESS_OPTIONS_NULL;
+    options.num_threads = num_threads;
+    options.pool        = pool;
+    options.running     = &running;
+    options.deadline_ms = deadline_ms;
+    options.quality     = quality;
+    rgb24_texture_t   output_texture   = RGB24_TEXTURE_NULL,
+                      previous_texture = RGB24_TEXTURE_NULL;
+    tilize_tile_map_t tile_map         = TILIZE_TILE_MAP_NULL;
+    mtx_t             tile_map_mtx;
+    int               tile_map_mtx_ok  = 0;
+    checkpoint_t     *checkpoint       = NULL;
+    void            (*previous_int)(int)  = SIG_ERR,
+                    (*previous_term)(int) = SIG_ERR;
+    int ret_code,
+        app_ret_code = 1;
+
+    // only tilize what changed since the previous result, the region of interest, this shard's rows and what isn't in the checkpoint yet, saving checkpoints along the way
+    if(shard_count > 0 || checkpoint_path || previous_path || tile_map_path || roi || mask_path){
+        if(tilize_tile_map_create(&tile_map, context, input_texture)){
+            VERRPRINT(0, "Failed to create tile_map");
+            goto _clean_and_exit;
+        }
+        if(previous_path && region_from_previous(&tile_map, &previous_texture, context, input_texture, previous_path, old_input_path, dirty_rects)){
+            VERRPRINTF(0, "Failed to find what changed since %s", previous_path);
+            goto _clean_and_exit;
         }
-        thread_data = malloc((num_threads - 1) * sizeof(*thread_data));
-        if(!thread_data){
-            VERRPRINT(0, "Failed to allocate thread_data");
-            goto _main_process;
+        if((roi || mask_path) && region_restrict(&tile_map, roi, mask_path)){
+            VERRPRINT(0, "Failed to restrict tile_map to the region of interest");
+            goto _clean_and_exit;
         }
-        for(int i = 0; i < num_threads - 1; ++i){
-            thread_data[i].ct_min        = (input_atlas.tile_amount_x * input_atlas.tile_amount_y) * (i + 1) / num_threads;
-            thread_data[i].ct_max        = (input_atlas.tile_amount_x * input_atlas.tile_amount_y) * (i + 2) / num_threads;
-            thread_data[i].input_atlas   = &input_atlas;
-            thread_data[i].running       = &running;
-            #if GUI_SUPPORTED
-                thread_data[i].check_sdl = (i == 2) ? 1 : 0;
-            #endif
-            if(thrd_create(&process_threads[i], &process_loop, &thread_data[i]) != thrd_success){
-                VERRPRINTF(0, "Failed to initialize process_threads[%i]", i);
-                goto _main_process;
+        if(resume){
+            FILE *checkpoint_test = fopen(checkpoint_path, "rb");
+            if(!checkpoint_test){
+                VPRINTF(1, "Warning: There is no checkpoint at %s to resume from, starting over\n", checkpoint_path);
+            }
+            else{
+                fclose(checkpoint_test);
+                if(checkpoint_resume(&tile_map, checkpoint_path)){
+                    VERRPRINT(0, "Failed to resume from checkpoint, remove it to start over");
+                    goto _clean_and_exit;
+                }
             }
         }
+        if(shard_count > 0) shard_restrict(&tile_map, shard_index, shard_count);
+        options.tile_map = &tile_map;
     }
-    _main_process:;
-    struct app_thread_data main_thrd_data;
-    main_thrd_data.ct_min        = 0;
-    main_thrd_data.ct_max        = input_atlas.tile_amount_x * input_atlas.tile_amount_y / num_threads;
-    main_thrd_data.input_atlas   = &input_atlas;
-    main_thrd_data.running       = &running;
-    #if GUI_SUPPORTED
-        main_thrd_data.check_sdl = (num_threads > 1) ? 0 : 1;
-    #endif
-    int total_ret_code = 0;
-    total_ret_code |= process_loop(&main_thrd_data);
-    if(num_threads > 1){
-        if(process_threads){
-            for(int i = 0; i < num_threads - 1; ++i){
-                int ret_code;
-                thrd_join(process_threads[i], &ret_code);
-                total_ret_code |= ret_code;
-            }
-            free(process_threads);
+    if(checkpoint_s > 0){
+        if(mtx_init(&tile_map_mtx, mtx_plain) != thrd_success){
+            VERRPRINT(0, "Failed to initialize tile_map_mtx");
+            goto _clean_and_exit;
+        }
+        tile_map_mtx_ok      = 1;
+        options.tile_map_mtx = &tile_map_mtx;
+        if(checkpoint_start(&checkpoint, &tile_map, &tile_map_mtx, checkpoint_path, checkpoint_s * 1000)){
+            VERRPRINT(0, "Failed to start checkpoint");
+            goto _clean_and_exit;
         }
-        if(thread_data) free(thread_data);
     }
+
+    // interrupting cancels tilizing like closing the gui does, so the checkpoint still gets saved one last time
+    previous_int  = signal(SIGINT, &handle_stop_signal);
+    previous_term = signal(SIGTERM, &handle_stop_signal);
+
     #if GUI_SUPPORTED
-        if(show_gui) gui_present();
+        if(show_gui){
+            // show previous image
+            gui_render_texture(0, 0, input_texture);
+            gui_present();
+
+            // process on another thread, this one drives the gui
+            int tile_size[2];
+            tilize_context_tile_size(context, &tile_size[0], &tile_size[1]);
+            options.tile_callback = &render_tile;
+            options.user_data     = tile_size;
+            atomic_int threads_left;
+            atomic_store(&threads_left, 1);
+            struct app_runner_data runner_data;
+            runner_data.input_texture  = input_texture;
+            runner_data.output_texture = &output_texture;
+            runner_data.options        = &options;
+            runner_data.threads_left   = &threads_left;
+            runner_data.ret_code       = 1;
+            thrd_t runner_thread;
+            if(thrd_create(&runner_thread, &process_runner, &runner_data) != thrd_success){
+                VERRPRINT(0, "Failed to initialize runner_thread");
+                goto _clean_and_exit;
+            }
+
+            // present and handle events until processing is done or the user cancels
+            if(gui_run(&running, &threads_left)){
+                VERRPRINT(0, "Failed to run gui");
+                atomic_store(&running, 0);
+            }
+            thrd_join(runner_thread, NULL);
+            gui_present();
+            ret_code = runner_data.ret_code;
+        }
+        else
     #endif
+    ret_code = tilize_process(context, input_texture, &output_texture, &options);
+    if(previous_int != SIG_ERR)  signal(SIGINT, previous_int);
+    if(previous_term != SIG_ERR) signal(SIGTERM, previous_term);
+    previous_int  = SIG_ERR;
+    previous_term = SIG_ERR;
 
-    if(total_ret_code & 1){
-        VERRPRINT(0, "Failed to complete all threads");
-        rgb24_atlas_destroy(&input_atlas);
-        return 1;
+    // save what's done, even if tilizing didn't finish
+    if(checkpoint){
+        if(checkpoint_stop(checkpoint)) VPRINTF(1, "Warning: Failed to save last checkpoint to %s\n", checkpoint_path);
+        checkpoint = NULL;
     }
-    else if(total_ret_code & 2){
+
+    if(ret_code == 1){
+        VERRPRINT(0, "Failed to tilize input_texture");
+        goto _clean_and_exit;
+    }
+    else if(ret_code == 2){
         VPRINT(1, "Cancelled Tilizing\n");
-        rgb24_atlas_destroy(&input_atlas);
-        return 0;
+        if(checkpoint_s > 0) VPRINTF(1, "Finished tiles are saved in %s, use `--resume` to continue\n", checkpoint_path);
+        app_ret_code = stop_requested ? 2 : 0;
+        goto _clean_and_exit;
     }
 
-    // output to file
-    if(output_file){
-        rgb24_texture_t output_texture = RGB24_TEXTURE_NULL;
-        if(rgb24_texture_from_atlas(&output_texture, &input_atlas)){
-            VERRPRINT(0, "Failed to generate output_texture from input_atlas");
-            rgb24_atlas_destroy(&input_atlas);
-            return 1;
+    // tiles kept from the previous result image or outside the region of interest
+    if(previous_texture.data) tilize_tile_map_copy_skipped(&tile_map, &output_texture, &previous_texture);
+    else if(roi || mask_path) tilize_tile_map_copy_skipped(&tile_map, &output_texture, input_texture);
+
+    // output tile map to file
+    if(tile_map_path && tilize_tile_map_save(&tile_map, tile_map_path)){
+        VERRPRINTF(0, "Failed to save tile_map to %s", tile_map_path);
+        goto _clean_and_exit;
+    }
+    // output shard to file
+    if(output_file && shard_count > 0){
+        if(tilize_tile_map_save(&tile_map, output_file)){
+            VERRPRINTF(0, "Failed to save tile_map to %s", output_file);
+            goto _clean_and_exit;
         }
-        if(save_png(output_file, &output_texture)){
+    }
+    // output to file
+    else if(output_file){
+        if(save_png_as(output_file, output_format, &output_texture)){
             VERRPRINTF(0, "Failed to save output_texture to %s", output_file);
-            rgb24_texture_destroy(&output_texture);
-            rgb24_atlas_destroy(&input_atlas);
-            return 1;
+            goto _clean_and_exit;
         }
-        rgb24_texture_destroy(&output_texture);
     }
+    // the checkpoint isn't needed anymore once the result is saved
+    if(checkpoint_path) remove(checkpoint_path);
+    // but the result might be again
+    if(cache_dir && cache_key_str[0] && cache_store(cache_dir, cache_key_str, output_file, cache_mib)) VPRINTF(1, "Warning: Failed to store %s in the cache\n", output_file);
+    app_ret_code = 0;
 
     // clean and return
-    rgb24_atlas_destroy(&input_atlas);
-    return 0;
+_clean_and_exit:
+    if(previous_int != SIG_ERR)  signal(SIGINT, previous_int);
+    if(previous_term != SIG_ERR) signal(SIGTERM, previous_term);
+    if(checkpoint) checkpoint_stop(checkpoint);
+    if(tile_map_mtx_ok) mtx_destroy(&tile_map_mtx);
+    rgb24_texture_destroy(&output_texture);
+    rgb24_texture_destroy(&previous_texture);
+    tilize_tile_map_destroy(&tile_map);
+    return app_ret_code;
 }
 
-// performs the loop that does the thing
-static int process_loop(void *input_data_void){
-    // macros for convenience
-    #define input_data  ((struct app_thread_data *)input_data_void)
-    #define input_atlas (input_data->input_atlas)
-    const int ct_min = input_data->ct_min,
-              ct_max = input_data->ct_max;
-    for(int ct_i = ct_min; ct_i < ct_max; ++ct_i){
-        if(!atomic_load(input_data->running)) return 2; // exit if told to do so
-        const int ct_x = ct_i % input_atlas->tile_amount_x,
-                  ct_y = ct_i / input_atlas->tile_amount_x;
-
-        // do the thing
-        // TODO: make more readable and such
-        const rgb24_t *current_tile = input_atlas->data[ct_i];
-        unsigned long lowest_diff = ULONG_MAX;
-        int lowest_pt   = 0,
-            lowest_col1 = 0,
-            lowest_col2 = 0;
-        for(int pt_i = 0; pt_i < pattern_atlas.tile_amount_x * pattern_atlas.tile_amount_y; ++pt_i){
-            for(int col1 = col1_min; col1 < col1_max; ++col1){
-                for(int col2 = col2_min; col2 < col2_max; ++col2){
-                    unsigned long difference = get_difference(current_tile, pt_i, col1, col2);
-                    if(difference < lowest_diff){
-                        lowest_diff = difference;
-                        lowest_pt   = pt_i;
-                        lowest_col1 = col1;
-                        lowest_col2 = col2;
-                    }
-                }
-            }
-        }
-
-        // colorize best tile
-        rgb24_texture_t best_pattern_colorized = RGB24_TEXTURE_NULL;
-        if(rgb24_atlas_get_tile(&best_pattern_colorized, &pattern_atlas, lowest_pt % pattern_atlas.tile_amount_x, lowest_pt / pattern_atlas.tile_amount_x)){
-            VERRPRINTF(0, "Failed to get best_pattern_colorized (lowest_pt = %i) from pattern_atlas", lowest_pt);
-            return 1;
-        }
-        for(int i = 0; i < best_pattern_colorized.width * best_pattern_colorized.height; ++i){
-            if(best_pattern_colorized.data[i].r >= 0x80) best_pattern_colorized.data[i] = colors[lowest_col1];
-            else                                         best_pattern_colorized.data[i] = colors[lowest_col2];
-        }
-        #if GUI_SUPPORTED
-            // render best tile to gui
-            if(show_gui){
-                gui_render_texture(ct_x * input_atlas->tile_width, ct_y * input_atlas->tile_height, &best_pattern_colorized);
-                // try presenting every ... tiles
-                if(ct_i % PRESENT_ITERATIONS == 0) gui_present();
-            }
-            if(input_data->check_sdl){
-                SDL_PumpEvents();
-                SDL_Event e;
-                while(SDL_PollEvent(&e)){
-                    switch(e.type){
-                        case SDL_QUIT:
-                            atomic_store(input_data->running, 0);
-                            break;
-                        case SDL_KEYDOWN:
-                            if(e.key.keysym.scancode == SDL_SCANCODE_Q ||
-                               e.key.keysym.scancode == SDL_SCANCODE_ESCAPE){
-                                atomic_store(input_data->running, 0);
-                            }
-                            break;
-                    }
-                }
-            }
-        #endif
-        // save best tile to input_atlas
-        rgb24_atlas_set_tile(input_atlas, &best_pattern_colorized, ct_x, ct_y);
-        // clean up
-        rgb24_texture_destroy(&best_pattern_colorized);
-    }
-    return 0;
-    #undef input_data
-    #undef input_atlas
+// sets stop_requested and clears running
+static void handle_stop_signal(int signal_number){
+    (void)signal_number;
+    stop_requested = 1;
+    atomic_store(&running, 0);
 }
-// gets difference between a pattern with specific colors and an rgb24_t array
-static unsigned long get_difference(const rgb24_t *restrict current_tile, int pattern_index, int col1, int col2){
-    unsigned long difference = 0;
-    const rgb24_t *pattern_tile = pattern_atlas.data[pattern_index];
-    for(int i = 0; i < pattern_atlas.tile_width * pattern_atlas.tile_height; ++i){
-        rgb24_t col_cmp;
-        if(pattern_tile[i].r >= 0x80) col_cmp = colors[col1];
-        else                          col_cmp = colors[col2];
-        difference += abs(col_cmp.r - (int)current_tile[i].r);
-        difference += abs(col_cmp.g - (int)current_tile[i].g);
-        difference += abs(col_cmp.b - (int)current_tile[i].b);
+#if GUI_SUPPORTED
+    // renders a finished tile to the gui
+    static void render_tile(void *user_data, int tile_x, int tile_y, const rgb24_texture_t *tile){
+        const int *tile_size = user_data;
+        gui_render_texture(tile_x * tile_size[0], tile_y * tile_size[1], tile);
     }
-    return difference;
-}
+    // runs tilize_process() off the gui thread
+    static int process_runner(void *runner_data_void){
+        struct app_runner_data *runner_data = runner_data_void;
+        runner_data->ret_code = tilize_process(context, runner_data->input_texture, runner_data->output_texture, runner_data->options);
+        atomic_fetch_sub(runner_data->threads_left, 1);
+        return 0;
+    }
+#endif
@@ -36,13 +36,19 @@
 
 #include "configuration.h"
 #include "texture.h"
+#include "thread_pool.h"
 
 // sets up application with the provided configs
-int application_setup(const tilize_config_t *restrict tilize_config, const flag_config_t *restrict flag_config);
+// thread_pool is used for tilizing if not NULL, it has to stay around until application_free()
+int application_setup(const flag_config_t *restrict flag_config, thread_pool_t *thread_pool);
 // frees everything application uses
 void application_free(void);
 
+// looks up the result for the image file at input_path in the cache (if one is used), *hit is set to whether it was found and saved to the output
+// the image doesn't have to be decoded for this, on a hit there's nothing left to do
+int application_fetch_cached(const char *input_path, int *hit);
 // processes input
+// returns 0 on success (including being cancelled through the gui), 1 on failure and 2 if cancelled by SIGINT or SIGTERM
 int application_process(const rgb24_texture_t *restrict input_texture);
 
 #endif
@@ -34,6 +34,7 @@
 #include "atlas.h"
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <math.h>
 #include "print.h"
 
@@ -141,6 +142,65 @@ int rgb24_atlas_from_texture(rgb24_atlas_t *restrict atlas, const rgb24_texture_
     return 0;
 }
 
+// splits texture into planar atlas of {tile_width, tile_height} sized tiles
+int planar_atlas_from_texture(planar_atlas_t *restrict atlas, const rgb24_texture_t *restrict texture, int tile_width, int tile_height){
+    return planar_atlas_from_texture_tiles(atlas, texture, tile_width, tile_height, NULL, 0);
+}
+// splits texture into planar atlas of {tile_width, tile_height} sized tiles like planar_atlas_from_texture(), but only fills in the num_tiles tiles
+// whose indecies (x + y * tile_amount_x) are in tiles, the others are left uninitialized; if tiles is NULL all of them are filled in
+int planar_atlas_from_texture_tiles(planar_atlas_t *restrict atlas, const rgb24_texture_t *restrict texture, int tile_width, int tile_height, const int *restrict tiles, int num_tiles){
+    // basic stuff
+    atlas->tile_width    = tile_width;
+    atlas->tile_height   = tile_height;
+    atlas->tile_amount_x = (int)ceil(texture->width / (double)tile_width);
+    atlas->tile_amount_y = (int)ceil(texture->height / (double)tile_height);
+    atlas->plane_size    = (tile_width * tile_height + PLANAR_ALIGNMENT - 1) / PLANAR_ALIGNMENT * PLANAR_ALIGNMENT;
+    if(!tiles) num_tiles = atlas->tile_amount_x * atlas->tile_amount_y;
+
+    // allocate, with room to move data up to the next aligned address
+    const size_t size = (size_t)atlas->tile_amount_x * atlas->tile_amount_y * 3 * atlas->plane_size;
+    atlas->allocation = malloc(size + PLANAR_ALIGNMENT - 1);
+    if(!atlas->allocation){
+        VERRPRINT(0, "Failed to allocate atlas->allocation");
+        return 1;
+    }
+    atlas->data = (unsigned char *)atlas->allocation + (PLANAR_ALIGNMENT - (uintptr_t)atlas->allocation % PLANAR_ALIGNMENT) % PLANAR_ALIGNMENT;
+
+    // copy data, repeating the last row and column where tiles go past texture
+    for(int i = 0; i < num_tiles; ++i){
+        const int      tile = tiles ? tiles[i] : i,
+                       x1   = tile % atlas->tile_amount_x,
+                       y1   = tile / atlas->tile_amount_x;
+        unsigned char *r    = atlas->data + (size_t)tile * 3 * atlas->plane_size,
+                      *g    = r + atlas->plane_size,
+                      *b    = g + atlas->plane_size;
+        for(int y2 = 0; y2 < tile_height; ++y2){
+            int y = y2 + y1 * tile_height;
+            if(y >= texture->height) y = texture->height - 1;
+            for(int x2 = 0; x2 < tile_width; ++x2){
+                int x = x2 + x1 * tile_width;
+                if(x >= texture->width) x = texture->width - 1;
+                const rgb24_t pixel = texture->data[x + y * texture->width];
+                r[x2 + y2 * tile_width] = pixel.r;
+                g[x2 + y2 * tile_width] = pixel.g;
+                b[x2 + y2 * tile_width] = pixel.b;
+            }
+        }
+        for(int j = tile_width * tile_height; j < atlas->plane_size; ++j){
+            r[j] = r[j - 1];
+            g[j] = g[j - 1];
+            b[j] = b[j - 1];
+        }
+    }
+
+    return 0;
+}
+// destroyes atlas
+void planar_atlas_destroy(planar_atlas_t *atlas){
+    free(atlas->allocation);
+    *atlas = PLANAR_ATLAS_NULL;
+}
+
 // gets the tile at {x, y} in atlas as a texture
 int rgb24_atlas_get_tile(rgb24_texture_t *restrict tile_texture, const rgb24_atlas_t *restrict atlas, int x, int y){
     // create tile_texture
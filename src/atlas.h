@@ -50,6 +50,23 @@ typedef struct rgb24_atlas_t{
 
 #define RGB24_ATLAS_NULL ((rgb24_atlas_t){0, 0, 0, 0, 0, 0, NULL})
 
+// what planes in a planar_atlas_t are aligned and padded to, enough for 256 bit vectors
+#define PLANAR_ALIGNMENT 32
+
+// a collection of tiles stored one after another, each as separate planes of r, g and b values
+// tile i starts at data + i * 3 * plane_size, with its r plane, then its g plane, then its b plane
+typedef struct planar_atlas_t{
+    int            tile_width,
+                   tile_height,
+                   tile_amount_x,
+                   tile_amount_y,
+                   plane_size;    // tile_width * tile_height rounded up to PLANAR_ALIGNMENT, padding repeats the last pixel
+    unsigned char *data;          // aligned to PLANAR_ALIGNMENT
+    void          *allocation;    // what data points into
+} planar_atlas_t;
+
+#define PLANAR_ATLAS_NULL ((planar_atlas_t){0, 0, 0, 0, 0, NULL, NULL})
+
 // creates a new atlas
 // if total_width or total_height == -1, they are automatically added in
 int rgb24_atlas_create(rgb24_atlas_t *atlas, int tile_width, int tile_height, int tile_amount_x, int tile_amount_y, int total_width, int total_height);
@@ -61,6 +78,14 @@ int rgb24_texture_from_atlas(rgb24_texture_t *restrict texture, const rgb24_atla
 // splits texture into atlas of {tile_width, tile_height} sized tiles
 int rgb24_atlas_from_texture(rgb24_atlas_t *restrict atlas, const rgb24_texture_t *restrict texture, int tile_width, int tile_height);
 
+// splits texture into planar atlas of {tile_width, tile_height} sized tiles
+int planar_atlas_from_texture(planar_atlas_t *restrict atlas, const rgb24_texture_t *restrict texture, int tile_width, int tile_height);
+// splits texture into planar atlas of {tile_width, tile_height} sized tiles like planar_atlas_from_texture(), but only fills in the num_tiles tiles
+// whose indecies (x + y * tile_amount_x) are in tiles, the others are left uninitialized; if tiles is NULL all of them are filled in
+int planar_atlas_from_texture_tiles(planar_atlas_t *restrict atlas, const rgb24_texture_t *restrict texture, int tile_width, int tile_height, const int *restrict tiles, int num_tiles);
+// destroyes atlas
+void planar_atlas_destroy(planar_atlas_t *atlas);
+
 // gets the tile at {x, y} in atlas as a texture
 int rgb24_atlas_get_tile(rgb24_texture_t *restrict tile_texture, const rgb24_atlas_t *restrict atlas, int x, int y);
 // sets tile at {x, y} in atlas to tile_texture
@@ -0,0 +1,50 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#ifndef BUILTIN_CONFIGS_H__
+#define BUILTIN_CONFIGS_H__
+
+#include "tilize.h"
+
+// builtin_configs.c is generated at build time by TilizeEmbed (see `tools/embed.c`), which can't run when cross compiling
+#ifndef BUILTIN_CONFIGS_SUPPORTED
+    #define BUILTIN_CONFIGS_SUPPORTED 1
+#endif
+
+#if BUILTIN_CONFIGS_SUPPORTED
+    // the configurations from resources/, usable with `-c builtin:[name]` once passed to tilize_set_builtins()
+    extern const tilize_builtin_t builtin_configs[];
+    extern const int              num_builtin_configs;
+#endif
+
+#endif
@@ -0,0 +1,281 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#if defined(__unix__)
+    #define _POSIX_C_SOURCE 200809L
+#endif
+#include "cache.h"
+
+#if CACHE_SUPPORTED
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <string.h>
+    #include <stdint.h>
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <dirent.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #include "map_file.h"
+    #include "print.h"
+
+    // version of the cache keys, bump it when what goes into them changes
+    #define CACHE_VERSION 1u
+    // size of the buffer files are copied through
+    #define COPY_BUFFER_SIZE 65536
+
+    // an entry found while making room
+    struct cache_entry{
+        char     *path;
+        long long size;
+        time_t    last_used;
+    };
+
+    // continues the 64 bit fnv-1a hash hash with size bytes at data
+    static uint64_t fnv1a64(uint64_t hash, const void *data, size_t size);
+    // copies the file at from_path to to_path
+    static int copy_file(const char *from_path, const char *to_path);
+    // creates the path of name in cache_dir, returns NULL on failure
+    static char *entry_path(const char *cache_dir, const char *name);
+    // removes the least recently used entries of cache_dir until it's at most max_bytes large
+    static int make_room(const char *cache_dir, long long max_bytes);
+    // compares two cache_entrys, least recently used first
+    static int compare_entries(const void *a, const void *b);
+
+    // puts the key of tilizing the image file at input_path (its bytes, not its pixels, so it doesn't have to be decoded) with context and quality
+    // into a file with the extension of output_path by this version of Tilize (see `TILIZE_RESULT_VERSION`) into key
+    int cache_key(char key[CACHE_KEY_LENGTH + 1], const char *input_path, const tilize_context_t *context, int quality, const char *output_path){
+        mapped_file_t input = MAPPED_FILE_NULL;
+        if(map_file(&input, input_path)){
+            VERRPRINTF(0, "Failed to map %s", input_path);
+            return 1;
+        }
+        const uint32_t    config_hash = tilize_context_hash(context);
+        const char       *extension   = strrchr(output_path, '.');
+        const long long   input_size  = input.size;
+        const uint32_t    cache_version  = CACHE_VERSION,
+                          result_version = TILIZE_RESULT_VERSION;
+        uint64_t hash = fnv1a64(14695981039346656037u, &cache_version, sizeof(cache_version));
+        hash = fnv1a64(hash, &result_version, sizeof(result_version));
+        hash = fnv1a64(hash, &config_hash, sizeof(config_hash));
+        hash = fnv1a64(hash, &quality, sizeof(quality));
+        if(extension) hash = fnv1a64(hash, extension, strlen(extension) + 1);
+        hash = fnv1a64(hash, &input_size, sizeof(input_size));
+        hash = fnv1a64(hash, input.data, input.size);
+        unmap_file(&input);
+        snprintf(key, CACHE_KEY_LENGTH + 1, "%016llx", (unsigned long long)hash);
+        return 0;
+    }
+    // copies the entry key of cache_dir to output_path if there is one, setting *hit to whether there was
+    int cache_fetch(const char *cache_dir, const char *key, const char *output_path, int *hit){
+        *hit = 0;
+        char *path = entry_path(cache_dir, key);
+        if(!path) return 1;
+        FILE *test = fopen(path, "rb");
+        if(!test){
+            VPRINTF(2, "Cache miss for %s\n", key);
+            free(path);
+            return 0;
+        }
+        fclose(test);
+        if(copy_file(path, output_path)){
+            VERRPRINTF(0, "Failed to copy %s to %s", path, output_path);
+            free(path);
+            return 1;
+        }
+        utimensat(AT_FDCWD, path, NULL, 0); // mark as just used
+        VPRINTF(2, "Cache hit for %s\n", key);
+        free(path);
+        *hit = 1;
+        return 0;
+    }
+    // copies output_path into cache_dir as the entry key, then removes the least recently used entries until cache_dir is at most max_mib MiB
+    int cache_store(const char *cache_dir, const char *key, const char *output_path, int max_mib){
+        if(mkdir(cache_dir, 0777) && errno != EEXIST){
+            VERRPRINTF(0, "Failed to create %s", cache_dir);
+            return 1;
+        }
+        char temp_name[CACHE_KEY_LENGTH + 32];
+        snprintf(temp_name, sizeof(temp_name), "%s.tmp%ld", key, (long)getpid());
+        char *path      = entry_path(cache_dir, key),
+             *temp_path = entry_path(cache_dir, temp_name);
+        int ret_code = 1;
+        if(!path || !temp_path) goto _clean_and_exit;
+        if(copy_file(output_path, temp_path)){
+            VERRPRINTF(0, "Failed to copy %s to %s", output_path, temp_path);
+            remove(temp_path);
+            goto _clean_and_exit;
+        }
+        if(rename(temp_path, path)){
+            VERRPRINTF(0, "Failed to rename %s to %s", temp_path, path);
+            remove(temp_path);
+            goto _clean_and_exit;
+        }
+        ret_code = make_room(cache_dir, (long long)max_mib * 1024 * 1024);
+
+    _clean_and_exit:
+        free(path);
+        free(temp_path);
+        return ret_code;
+    }
+
+    // continues the 64 bit fnv-1a hash hash with size bytes at data
+    static uint64_t fnv1a64(uint64_t hash, const void *data, size_t size){
+        const unsigned char *bytes = data;
+        for(size_t i = 0; i < size; ++i){
+            hash ^= bytes[i];
+            hash *= 1099511628211u;
+        }
+        return hash;
+    }
+    // copies the file at from_path to to_path
+    static int copy_file(const char *from_path, const char *to_path){
+        unsigned char *buffer = malloc(COPY_BUFFER_SIZE);
+        if(!buffer){
+            VERRPRINT(0, "Failed to allocate buffer");
+            return 1;
+        }
+        FILE *from = fopen(from_path, "rb");
+        if(!from){
+            free(buffer);
+            return 1;
+        }
+        FILE *to = fopen(to_path, "wb");
+        if(!to){
+            fclose(from);
+            free(buffer);
+            return 1;
+        }
+        int ret_code = 0;
+        size_t read;
+        while((read = fread(buffer, 1, COPY_BUFFER_SIZE, from)) > 0){
+            if(fwrite(buffer, 1, read, to) != read){
+                ret_code = 1;
+                break;
+            }
+        }
+        if(ferror(from)) ret_code = 1;
+        fclose(from);
+        if(fclose(to)) ret_code = 1;
+        free(buffer);
+        return ret_code;
+    }
+    // creates the path of name in cache_dir, returns NULL on failure
+    static char *entry_path(const char *cache_dir, const char *name){
+        char *path = malloc(strlen(cache_dir) + strlen(name) + 2);
+        if(!path){
+            VERRPRINT(0, "Failed to allocate path");
+            return NULL;
+        }
+        sprintf(path, "%s/%s", cache_dir, name);
+        return path;
+    }
+    // removes the least recently used entries of cache_dir until it's at most max_bytes large
+    static int make_room(const char *cache_dir, long long max_bytes){
+        DIR *dir = opendir(cache_dir);
+        if(!dir){
+            VERRPRINTF(0, "Failed to open %s", cache_dir);
+            return 1;
+        }
+        int                 ret_code    = 1,
+                            num_entries = 0,
+                            max_entries = 0,
+                            num_removed = 0;
+        long long           total_bytes = 0;
+        struct cache_entry *entries     = NULL;
+        struct dirent      *dirent;
+        while((dirent = readdir(dir))){
+            // only finished entries, temporary files might still be written
+            if(strlen(dirent->d_name) != CACHE_KEY_LENGTH || strspn(dirent->d_name, "0123456789abcdef") != CACHE_KEY_LENGTH) continue;
+            if(num_entries == max_entries){
+                max_entries = max_entries ? max_entries * 2 : 64;
+                struct cache_entry *new_entries = realloc(entries, max_entries * sizeof(*entries));
+                if(!new_entries){
+                    VERRPRINT(0, "Failed to allocate entries");
+                    goto _clean_and_exit;
+                }
+                entries = new_entries;
+            }
+            struct stat entry_stat;
+            char *path = entry_path(cache_dir, dirent->d_name);
+            if(!path) goto _clean_and_exit;
+            if(stat(path, &entry_stat)){ // removed by someone else in the meantime
+                free(path);
+                continue;
+            }
+            entries[num_entries++] = (struct cache_entry){path, entry_stat.st_size, entry_stat.st_mtime};
+            total_bytes += entry_stat.st_size;
+        }
+        qsort(entries, num_entries, sizeof(*entries), compare_entries);
+        for(int i = 0; i < num_entries && total_bytes > max_bytes; ++i){
+            if(remove(entries[i].path)) continue;
+            total_bytes -= entries[i].size;
+            ++num_removed;
+        }
+        VPRINTF(2, "Cache has %i entries with %lli of at most %lli KiB, removed %i\n", num_entries - num_removed, total_bytes / 1024, max_bytes / 1024, num_removed);
+        ret_code = 0;
+
+    _clean_and_exit:
+        for(int i = 0; i < num_entries; ++i) free(entries[i].path);
+        free(entries);
+        closedir(dir);
+        return ret_code;
+    }
+    // compares two cache_entrys, least recently used first
+    static int compare_entries(const void *a, const void *b){
+        const struct cache_entry *ea = a,
+                                 *eb = b;
+        if(ea->last_used != eb->last_used) return ea->last_used < eb->last_used ? -1 : 1;
+        return strcmp(ea->path, eb->path);
+    }
+#else
+    #include <stdio.h>
+
+    // dummy implementations to give warnings
+    int cache_key(char key[CACHE_KEY_LENGTH + 1], const char *input_path, const tilize_context_t *context, int quality, const char *output_path){
+        fprintf(stderr, "Warning: cache_key() not supported at compiletime\n");
+        int a = key[0] + input_path[0] + (context != NULL) + quality + output_path[0]; a = a + a; // to keep out some warnings
+        return 1;
+    }
+    int cache_fetch(const char *cache_dir, const char *key, const char *output_path, int *hit){
+        fprintf(stderr, "Warning: cache_fetch() not supported at compiletime\n");
+        int a = cache_dir[0] + key[0] + output_path[0]; a = a + a; // to keep out some warnings
+        *hit = 0;
+        return 1;
+    }
+    int cache_store(const char *cache_dir, const char *key, const char *output_path, int max_mib){
+        fprintf(stderr, "Warning: cache_store() not supported at compiletime\n");
+        int a = cache_dir[0] + key[0] + output_path[0] + max_mib; a = a + a; // to keep out some warnings
+        return 1;
+    }
+#endif
@@ -0,0 +1,70 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#ifndef CACHE_H__
+#define CACHE_H__
+
+#ifndef CACHE_SUPPORTED
+    #if defined(__unix__) || defined(__APPLE__)
+        #define CACHE_SUPPORTED 1
+    #else
+        #define CACHE_SUPPORTED 0
+    #endif
+#endif
+
+#include "tilize.h"
+
+// default limit of the size of a cache directory, in MiB
+#ifndef CACHE_DEFAULT_MIB
+    #define CACHE_DEFAULT_MIB 1024
+#endif
+#define CACHE_STRINGIFY_(x) #x
+#define CACHE_STRINGIFY(x)  CACHE_STRINGIFY_(x)
+// CACHE_DEFAULT_MIB as a string literal
+#define CACHE_DEFAULT_MIB_STRING CACHE_STRINGIFY(CACHE_DEFAULT_MIB)
+// length of a key, in hex digits
+#define CACHE_KEY_LENGTH 16
+
+// a directory of results, each saved under a key made from everything the result depends on
+// entries are written to a temporary file first and then renamed, so any amount of processes can share one cache
+// once the directory is larger than its limit, the entries used the longest time ago are removed
+
+// puts the key of tilizing the image file at input_path (its bytes, not its pixels, so it doesn't have to be decoded) with context and quality
+// into a file with the extension of output_path by this version of Tilize (see `TILIZE_RESULT_VERSION`) into key
+int cache_key(char key[CACHE_KEY_LENGTH + 1], const char *input_path, const tilize_context_t *context, int quality, const char *output_path);
+// copies the entry key of cache_dir to output_path if there is one, setting *hit to whether there was
+int cache_fetch(const char *cache_dir, const char *key, const char *output_path, int *hit);
+// copies output_path into cache_dir as the entry key, then removes the least recently used entries until cache_dir is at most max_mib MiB
+int cache_store(const char *cache_dir, const char *key, const char *output_path, int max_mib);
+
+#endif
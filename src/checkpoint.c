@@ -0,0 +1,162 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#include "checkpoint.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+#include "print.h"
+#include "timing.h"
+
+// how long the checkpoint thread sleeps between looking whether it should stop
+#define CHECKPOINT_POLL_MS 50
+
+struct checkpoint_t{
+    const tilize_tile_map_t *tile_map;
+    mtx_t                   *tile_map_mtx;
+    tilize_tile_map_t        copy;         // what gets saved, so tile_map_mtx isn't held while writing
+    char                    *path,
+                            *temp_path;    // written first, then renamed to path, so path is never half written
+    int                      interval_ms;
+    atomic_int               running;
+    thrd_t                   thread;
+};
+
+// saves checkpoint->tile_map to checkpoint->path
+static int checkpoint_save(checkpoint_t *checkpoint);
+// saves the tile map every checkpoint->interval_ms until checkpoint->running is cleared
+static int checkpoint_thread(void *checkpoint_void);
+
+// starts saving tile_map to the file at path every interval_ms, copying it while holding tile_map_mtx
+// tile_map_mtx should be given to tilize_process() as options.tile_map_mtx, so workers only wait for that copy and not for the file
+int checkpoint_start(checkpoint_t **checkpoint, const tilize_tile_map_t *tile_map, mtx_t *tile_map_mtx, const char *path, int interval_ms){
+    checkpoint_t *cp = calloc(1, sizeof(*cp));
+    if(!cp){
+        VERRPRINT(0, "Failed to allocate checkpoint");
+        return 1;
+    }
+    const size_t num_tiles = (size_t)tile_map->tile_amount_x * tile_map->tile_amount_y;
+    cp->tile_map       = tile_map;
+    cp->tile_map_mtx   = tile_map_mtx;
+    cp->copy           = *tile_map;
+    cp->copy.tiles     = malloc(num_tiles * sizeof(*cp->copy.tiles));
+    cp->path           = malloc(strlen(path) + 1);
+    cp->temp_path      = malloc(strlen(path) + 5);
+    cp->interval_ms    = interval_ms;
+    if(!cp->copy.tiles || !cp->path || !cp->temp_path){
+        VERRPRINT(0, "Failed to allocate copy.tiles, path or temp_path");
+        goto _fail;
+    }
+    strcpy(cp->path, path);
+    strcpy(cp->temp_path, path);
+    strcat(cp->temp_path, ".tmp");
+    atomic_store(&cp->running, 1);
+    if(thrd_create(&cp->thread, &checkpoint_thread, cp) != thrd_success){
+        VERRPRINT(0, "Failed to create checkpoint thread");
+        goto _fail;
+    }
+    *checkpoint = cp;
+    return 0;
+
+_fail:
+    free(cp->copy.tiles);
+    free(cp->path);
+    free(cp->temp_path);
+    free(cp);
+    return 1;
+}
+// stops and destroyes checkpoint, after saving its tile map one last time
+int checkpoint_stop(checkpoint_t *checkpoint){
+    atomic_store(&checkpoint->running, 0);
+    thrd_join(checkpoint->thread, NULL);
+    const int ret_code = checkpoint_save(checkpoint);
+    free(checkpoint->copy.tiles);
+    free(checkpoint->path);
+    free(checkpoint->temp_path);
+    free(checkpoint);
+    return ret_code;
+}
+
+// puts the finished tiles of the tile map at path into tile_map, made for the same image and configuration
+// returns 1 if it couldn't be loaded or was made for something else
+int checkpoint_resume(tilize_tile_map_t *tile_map, const char *path){
+    tilize_tile_map_t saved = TILIZE_TILE_MAP_NULL;
+    if(tilize_tile_map_load(&saved, path)){
+        VERRPRINTF(0, "Failed to load %s", path);
+        return 1;
+    }
+    if(tilize_tile_map_merge(tile_map, &saved)){
+        VERRPRINTF(0, "%s was made for a different image or configuration", path);
+        tilize_tile_map_destroy(&saved);
+        return 1;
+    }
+    tilize_tile_map_destroy(&saved);
+    return 0;
+}
+
+// saves checkpoint->tile_map to checkpoint->path
+static int checkpoint_save(checkpoint_t *checkpoint){
+    const size_t num_tiles = (size_t)checkpoint->copy.tile_amount_x * checkpoint->copy.tile_amount_y;
+    mtx_lock(checkpoint->tile_map_mtx);
+    memcpy(checkpoint->copy.tiles, checkpoint->tile_map->tiles, num_tiles * sizeof(*checkpoint->copy.tiles));
+    mtx_unlock(checkpoint->tile_map_mtx);
+    if(tilize_tile_map_save(&checkpoint->copy, checkpoint->temp_path)){
+        VERRPRINTF(0, "Failed to save checkpoint to %s", checkpoint->temp_path);
+        return 1;
+    }
+    if(rename(checkpoint->temp_path, checkpoint->path)){
+        VERRPRINTF(0, "Failed to rename %s to %s", checkpoint->temp_path, checkpoint->path);
+        return 1;
+    }
+    return 0;
+}
+// saves the tile map every checkpoint->interval_ms until checkpoint->running is cleared
+static int checkpoint_thread(void *checkpoint_void){
+    checkpoint_t *checkpoint = checkpoint_void;
+    ms_t next_save_ms = current_ms() + checkpoint->interval_ms;
+    while(atomic_load(&checkpoint->running)){
+        thrd_sleep(&(struct timespec){0, CHECKPOINT_POLL_MS * 1000000L}, NULL);
+        if(current_ms() < next_save_ms) continue;
+        if(checkpoint_save(checkpoint)){
+            VPRINTF(1, "Warning: Failed to save checkpoint to %s, trying again later\n", checkpoint->path);
+        }
+        else{
+            VPRINTF(2, "Saved checkpoint to %s\n", checkpoint->path);
+        }
+        next_save_ms = current_ms() + checkpoint->interval_ms;
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#ifndef CHECKPOINT_H__
+#define CHECKPOINT_H__
+
+#include "tilize.h"
+#include "tinycthread.h"
+
+// saves a tile map being filled in by tilize_process() to a file every so often on its own thread
+typedef struct checkpoint_t checkpoint_t;
+
+// starts saving tile_map to the file at path every interval_ms, copying it while holding tile_map_mtx
+// tile_map_mtx should be given to tilize_process() as options.tile_map_mtx, so workers only wait for that copy and not for the file
+int checkpoint_start(checkpoint_t **checkpoint, const tilize_tile_map_t *tile_map, mtx_t *tile_map_mtx, const char *path, int interval_ms);
+// stops and destroyes checkpoint, after saving its tile map one last time
+int checkpoint_stop(checkpoint_t *checkpoint);
+
+// puts the finished tiles of the tile map at path into tile_map, made for the same image and configuration
+// returns 1 if it couldn't be loaded or was made for something else
+int checkpoint_resume(tilize_tile_map_t *tile_map, const char *path);
+
+#endif
@@ -247,3 +247,68 @@ int tilize_config_deserialize(tilize_config_t *restrict config, const char *rest
     cJSON_Delete(root);
     return retcode;
 }
+
+// sets config to the default configuration, which has no pattern_path, meaning the default pattern is used
+int tilize_config_default(tilize_config_t *config){
+    config->pattern_path = NULL;
+    config->tile_width   = 4;
+    config->tile_height  = 4;
+    config->num_colors   = 2;
+    config->colors       = malloc(2 * sizeof(*config->colors));
+    if(!config->colors){
+        VERRPRINT(0, "Failed to allocate colors");
+        return 1;
+    }
+    config->colors[0]    = RGB24(0x00,0x00,0x00);
+    config->colors[1]    = RGB24(0xff,0xff,0xff);
+    config->bckg_color   = -1;
+    config->forg_color   = -1;
+    return 0;
+}
+// loads a configuration from the json file at path
+int tilize_config_load(tilize_config_t *restrict config, const char *restrict path){
+    FILE *config_file = fopen(path, "r");
+    if(!config_file){
+        VERRPRINT(0, "Failed to open config_file");
+        return 1;
+    }
+    if(fseek(config_file, 0, SEEK_END)){
+        VERRPRINT(0, "Failed to seek to end of config_file");
+        fclose(config_file);
+        return 1;
+    }
+    long config_file_size = ftell(config_file);
+    if(config_file_size == -1L){
+        VERRPRINT(0, "Failed to tell position in config_file");
+        fclose(config_file);
+        return 1;
+    }
+    rewind(config_file);
+    char *config_text = calloc(config_file_size + 16, sizeof(char));
+    if(!config_text){
+        VERRPRINT(0, "Failed to allocate config_text");
+        fclose(config_file);
+        return 1;
+    }
+    fread(config_text, sizeof(char), config_file_size + 8, config_file);
+    fclose(config_file);
+    if(tilize_config_deserialize(config, config_text)){
+        VERRPRINT(0, "Failed to deserialize config");
+        free(config_text);
+        return 1;
+    }
+    free(config_text);
+    return 0;
+}
+// frees everything config owns
+void tilize_config_free(tilize_config_t *config){
+    if(config->pattern_path){
+        free(config->pattern_path);
+        config->pattern_path = NULL;
+    }
+    if(config->colors){
+        free(config->colors);
+        config->colors = NULL;
+    }
+    config->num_colors = 0;
+}
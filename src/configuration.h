@@ -55,13 +55,35 @@ typedef struct flag_config_t{
     int   num_threads;
     char *config_path;          // path of tilize configuration used
     const char *file_outp_path; // path to file output
+    int   deadline_ms;          // if > 0, how long tilizing may take before the best result found so far is used
+    int   quality;              // percentage of the best result that has to be reached, lower is faster
+    int   shard_index,          // if shard_count > 0, only the rows of shard shard_index are tilized
+          shard_count;          // and a tile map is saved to file_outp_path instead of an image
+    int   checkpoint_s;         // if > 0, finished tiles are saved next to file_outp_path this often (in seconds)
+    int   resume;               // whether tiles already saved next to file_outp_path are used instead of searched again
+    const char *previous_path;  // if not NULL, a previous result (image or tile map) of which only the changed tiles are tilized again
+    const char *old_input_path; // image previous_path was made from, to find the changed tiles
+    const char *dirty_rects;    // rectangles `x,y,width,height`, separated by `:`, that changed since previous_path
+    const char *tile_map_path;  // if not NULL, the tile map of the result is saved here too
+    const char *roi;            // if not NULL, rectangles `x,y,width,height`, separated by `:`, outside of which the input is copied through
+    const char *mask_path;      // if not NULL, image outside of whose pixels with a red value of at least 128 the input is copied through
+    const char *cache_dir;      // if not NULL, directory results are cached in across runs
+    int   cache_mib;            // how large cache_dir may get, in MiB
+    const char *file_outp_format; // if not NULL, ending (like `.qoi` or `qoi`) of the format file_outp_path is saved in, instead of its own
 } flag_config_t;
 
-#define FLAG_CONFIG_NULL ((flag_config_t){0, 1, NULL, NULL})
+#define FLAG_CONFIG_NULL ((flag_config_t){0, 1, NULL, NULL, 0, 100, 0, 0, 0, 0, NULL, NULL, NULL, NULL, NULL, NULL, NULL, 0, NULL})
 
 // serializes a configuration into json
 int tilize_config_serialize(char **serialized, const tilize_config_t *restrict config);
 // deserializes a configuration from json
 int tilize_config_deserialize(tilize_config_t *restrict config, const char *restrict serialized);
 
+// sets config to the default configuration, which has no pattern_path, meaning the default pattern is used
+int tilize_config_default(tilize_config_t *config);
+// loads a configuration from the json file at path
+int tilize_config_load(tilize_config_t *restrict config, const char *restrict path);
+// frees everything config owns
+void tilize_config_free(tilize_config_t *config);
+
 #endif
@@ -34,30 +34,84 @@
 #include "gui.h"
 
 #if GUI_SUPPORTED
+    #include <stdlib.h>
     #include <stdint.h>
+    #include <stdatomic.h>
     #include <SDL2/SDL.h>
     #include "print.h"
     #include "rgb24.h"
     #include "texture.h"
     #include "tinycthread.h"
 
+    // width and height of the blocks changes are tracked in
+    #define DIRTY_BLOCK_SIZE 32
+
     // gui state
-    static SDL_Window   *gui_window;
-    static SDL_Renderer *gui_renderer;
-    static SDL_Surface  *gui_surface;
-    static int           gui_width,
-                         gui_height;
-    static mtx_t         render_mtx,
-                         present_mtx;
+    static SDL_Window    *gui_window;
+    static SDL_Renderer  *gui_renderer;
+    static SDL_Texture   *gui_texture;  // streaming texture, only updated where gui_dirty says so
+    static uint32_t      *gui_pixels;   // what gui_texture should look like
+    static atomic_uchar  *gui_dirty;    // one flag per DIRTY_BLOCK_SIZE^2 block of gui_pixels that changed since it was last uploaded
+    static int            gui_width,    // size of the preview, not of the image
+                          gui_height,
+                          image_width,
+                          image_height,
+                          gui_downscale, // every gui pixel covers gui_downscale^2 image pixels
+                          dirty_width,
+                          dirty_height;
+    static mtx_t          present_mtx;
+    static int            present_mtx_ok, // whether present_mtx was initialized
+                          gui_initialized,
+                          display_width, // size of the desktop, 0 if unknown
+                          display_height;
+
+    // marks all blocks overlapping the rectangle {x, y, width, height} (in gui coordinates) as dirty
+    static void mark_dirty(int x, int y, int width, int height);
 
+    // initializes SDL, which doesn't need to know the image yet and so can be done while it's still loading
+    // called by gui_setup() if it wasn't already, has to be called from the same thread as gui_setup()
+    int gui_init(void){
+        if(gui_initialized) return 0;
+        if(SDL_Init(SDL_INIT_VIDEO)){
+            if(get_verbosity() >= 0) fprintf(stderr, "Failed to initialize SDL in %s, %s, %i:\n%s\n", __FILE__, __func__, __LINE__, SDL_GetError());
+            return 1;
+        }
+        SDL_DisplayMode display_mode;
+        if(!SDL_GetDesktopDisplayMode(0, &display_mode)){
+            display_width  = display_mode.w;
+            display_height = display_mode.h;
+        }
+        gui_initialized = 1;
+        return 0;
+    }
     // sets up gui to render an image of size {width, height} and multiply its size by scalar for showing
+    // if the image is bigger than the display or GUI_MAX_WIDTH x GUI_MAX_HEIGHT, it is shown downscaled by an integer factor
     int gui_setup(int width, int height, int scalar){
         // initialize SDL
-        if(SDL_Init(SDL_INIT_VIDEO)){
-            if(get_verbosity() >= 0) fprintf(stderr, "Failed to initialize SDL in %s, %s, %i:\n%s\n", __FILE__, __func__, __LINE__, SDL_GetError());
+        if(gui_init()){
+            VERRPRINT(0, "Failed to initialize gui");
             return 1;
         }
 
+        // get preview size
+        int max_width  = GUI_MAX_WIDTH,
+            max_height = GUI_MAX_HEIGHT;
+        if(display_width  > 0 && display_width  < max_width)  max_width  = display_width;
+        if(display_height > 0 && display_height < max_height) max_height = display_height;
+        if(scalar < 1) scalar = 1;
+        max_width  /= scalar;
+        max_height /= scalar;
+        if(max_width < 1)  max_width  = 1;
+        if(max_height < 1) max_height = 1;
+        image_width   = width;
+        image_height  = height;
+        gui_downscale = 1;
+        if((width  + max_width  - 1) / max_width  > gui_downscale) gui_downscale = (width  + max_width  - 1) / max_width;
+        if((height + max_height - 1) / max_height > gui_downscale) gui_downscale = (height + max_height - 1) / max_height;
+        width  = (width  + gui_downscale - 1) / gui_downscale;
+        height = (height + gui_downscale - 1) / gui_downscale;
+        if(gui_downscale > 1) VPRINTF(2, "Showing preview downscaled by %i (%ix%i)\n", gui_downscale, width, height);
+
         // create window
         gui_window = SDL_CreateWindow("Tilize", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, width * scalar, height * scalar, SDL_WINDOW_SHOWN);
         if(!gui_window){
@@ -72,10 +126,10 @@
             return 1;
         }
 
-        // create surface
-        gui_surface = SDL_CreateRGBSurface(0, width, height, 32, 0xff0000, 0x00ff00, 0x0000ff, 0);
-        if(!gui_surface){
-            if(get_verbosity() >= 0) fprintf(stderr, "Failed to create gui_surface in %s, %s, %i:\n%s\n", __FILE__, __func__, __LINE__, SDL_GetError());
+        // create texture, kept alive for the whole run
+        gui_texture = SDL_CreateTexture(gui_renderer, SDL_PIXELFORMAT_RGB888, SDL_TEXTUREACCESS_STREAMING, width, height);
+        if(!gui_texture){
+            if(get_verbosity() >= 0) fprintf(stderr, "Failed to create gui_texture in %s, %s, %i:\n%s\n", __FILE__, __func__, __LINE__, SDL_GetError());
             return 1;
         }
 
@@ -83,38 +137,62 @@
         gui_width = width;
         gui_height = height;
 
-        // initialize mutexes
-        if(mtx_init(&render_mtx, mtx_plain) != thrd_success){
-            VERRPRINT(0, "Failed to initialize render_mtx");
+        // create pixel buffer (black screen)
+        gui_pixels = calloc((size_t)width * height, sizeof(*gui_pixels));
+        if(!gui_pixels){
+            VERRPRINT(0, "Failed to allocate gui_pixels");
+            return 1;
+        }
+
+        // create dirty bitmap, everything starts out dirty so the black screen gets uploaded
+        dirty_width  = (width  + DIRTY_BLOCK_SIZE - 1) / DIRTY_BLOCK_SIZE;
+        dirty_height = (height + DIRTY_BLOCK_SIZE - 1) / DIRTY_BLOCK_SIZE;
+        gui_dirty = malloc((size_t)dirty_width * dirty_height * sizeof(*gui_dirty));
+        if(!gui_dirty){
+            VERRPRINT(0, "Failed to allocate gui_dirty");
             return 1;
         }
+        for(int i = 0; i < dirty_width * dirty_height; ++i){
+            atomic_init(&gui_dirty[i], 1);
+        }
+
+        // initialize mutex
         if(mtx_init(&present_mtx, mtx_plain) != thrd_success){
             VERRPRINT(0, "Failed to initialize present_mtx");
             return 1;
         }
+        present_mtx_ok = 1;
 
-        // present initial scene (black screen)
-        uint32_t *pixels = (uint32_t *)gui_surface->pixels;
-        for(int i = 0; i < width * height; ++i){
-            pixels[i] = 0;
-        }
+        // present initial scene
         if(gui_present()){
             VERRPRINT(0, "Failed to render black scene");
         }
 
         return 0;
     }
-    // frees everything gui uses
+    // frees everything gui uses, does nothing if gui_init() didn't succeed
     void gui_free(void){
-        mtx_destroy(&render_mtx);
-        mtx_destroy(&present_mtx);
-        if(gui_surface){
-            SDL_UnlockSurface(gui_surface);
-            SDL_FreeSurface(gui_surface);
+        if(!gui_initialized) return;
+        if(present_mtx_ok){
+            mtx_destroy(&present_mtx);
+            present_mtx_ok = 0;
         }
+        if(gui_dirty){
+            free(gui_dirty);
+            gui_dirty = NULL;
+        }
+        if(gui_pixels){
+            free(gui_pixels);
+            gui_pixels = NULL;
+        }
+        if(gui_texture) SDL_DestroyTexture(gui_texture);
         if(gui_renderer) SDL_DestroyRenderer(gui_renderer);
         if(gui_window) SDL_DestroyWindow(gui_window);
+        gui_texture  = NULL;
+        gui_renderer = NULL;
+        gui_window   = NULL;
         SDL_Quit();
+        gui_initialized = 0;
     }
 
     // renders current visuals to the window
@@ -126,41 +204,41 @@
             return 1;
         }
 
-        if(mtx_lock(&render_mtx) != thrd_success){
-            VERRPRINT(0, "Failed to lock render_mtx");
-            if(mtx_unlock(&present_mtx) != thrd_success){
-                VERRPRINT(0, "Failed to unlock present_mtx");
-            }
-            return 1;
-        }
-        SDL_UnlockSurface(gui_surface);
-        // create texture to be rendered
-        SDL_Texture *gui_texture = SDL_CreateTextureFromSurface(gui_renderer, gui_surface);
-        if(!gui_texture){
-            if(get_verbosity() >= 0) fprintf(stderr, "Failed to create gui_texture in %s, %s, %i:\n%s\n", __FILE__, __func__, __LINE__, SDL_GetError());
-            if(mtx_unlock(&render_mtx) != thrd_success){
-                VERRPRINT(0, "Failed to unlock render_mtx");
-            }
-            if(mtx_unlock(&present_mtx) != thrd_success){
-                VERRPRINT(0, "Failed to unlock present_mtx");
-            }
-            return 1;
-        }
-        SDL_LockSurface(gui_surface);
-        if(mtx_unlock(&render_mtx) != thrd_success){
-            VERRPRINT(0, "Failed to unlock render_mtx");
-            if(mtx_unlock(&present_mtx) != thrd_success){
-                VERRPRINT(0, "Failed to unlock present_mtx");
+        // upload dirty blocks, merging horizontal runs into one rectangle each
+        for(int dy = 0; dy < dirty_height; ++dy){
+            int dx = 0;
+            while(dx < dirty_width){
+                if(!atomic_exchange(&gui_dirty[dx + dy * dirty_width], 0)){
+                    ++dx;
+                    continue;
+                }
+                int run_end = dx + 1;
+                while(run_end < dirty_width && atomic_exchange(&gui_dirty[run_end + dy * dirty_width], 0)) ++run_end;
+
+                SDL_Rect rect;
+                rect.x = dx * DIRTY_BLOCK_SIZE;
+                rect.y = dy * DIRTY_BLOCK_SIZE;
+                rect.w = run_end * DIRTY_BLOCK_SIZE - rect.x;
+                rect.h = DIRTY_BLOCK_SIZE;
+                if(rect.x + rect.w > gui_width)  rect.w = gui_width - rect.x;
+                if(rect.y + rect.h > gui_height) rect.h = gui_height - rect.y;
+                if(SDL_UpdateTexture(gui_texture, &rect, &gui_pixels[rect.x + rect.y * gui_width], gui_width * sizeof(*gui_pixels))){
+                    if(get_verbosity() >= 0) fprintf(stderr, "Failed to update gui_texture in %s, %s, %i:\n%s\n", __FILE__, __func__, __LINE__, SDL_GetError());
+                    if(mtx_unlock(&present_mtx) != thrd_success){
+                        VERRPRINT(0, "Failed to unlock present_mtx");
+                    }
+                    return 1;
+                }
+                dx = run_end;
             }
-            SDL_DestroyTexture(gui_texture);
-            return 1;
         }
 
-        // render said texture to gui_renderer
+        // render gui_texture to gui_renderer
         if(SDL_RenderCopy(gui_renderer, gui_texture, NULL, NULL)){
             if(get_verbosity() >= 0) fprintf(stderr, "Failed to render gui_texture to gui_renderer in %s, %s, %i:\n%s\n", __FILE__, __func__, __LINE__, SDL_GetError());
-            SDL_DestroyTexture(gui_texture);
-            SDL_LockSurface(gui_surface);
+            if(mtx_unlock(&present_mtx) != thrd_success){
+                VERRPRINT(0, "Failed to unlock present_mtx");
+            }
             return 1;
         }
 
@@ -168,7 +246,6 @@
         SDL_RenderPresent(gui_renderer);
 
         // cleanup and return
-        SDL_DestroyTexture(gui_texture);
         if(mtx_unlock(&present_mtx) != thrd_success){
             VERRPRINT(0, "Failed to unlock present_mtx");
             return 1;
@@ -176,72 +253,144 @@
         return 0;
     }
 
-    // sets pixel at {x, y} of gui's internal buffer to color
-    int gui_set_px(int x, int y, rgb24_t color){
-        if(mtx_lock(&render_mtx) != thrd_success){
-            VERRPRINT(0, "Failed to lock render_mtx");
-            return 1;
+    // presents and handles events until *threads_left reaches 0 or *running is set to 0
+    // sets *running to 0 if the user cancels, has to be called from the thread gui_setup() was called from
+    int gui_run(atomic_int *running, atomic_int *threads_left){
+        const Uint32 frame_ms = 1000 / GUI_FPS;
+        while(atomic_load(running) && atomic_load(threads_left) > 0){
+            const Uint32 frame_start = SDL_GetTicks();
+
+            // handle events
+            SDL_PumpEvents();
+            SDL_Event e;
+            while(SDL_PollEvent(&e)){
+                switch(e.type){
+                    case SDL_QUIT:
+                        atomic_store(running, 0);
+                        break;
+                    case SDL_KEYDOWN:
+                        if(e.key.keysym.scancode == SDL_SCANCODE_Q ||
+                           e.key.keysym.scancode == SDL_SCANCODE_ESCAPE){
+                            atomic_store(running, 0);
+                        }
+                        break;
+                }
+            }
+
+            // present
+            if(gui_present()){
+                VERRPRINT(0, "Failed to present");
+                return 1;
+            }
+
+            // wait for the rest of the frame
+            const Uint32 frame_time = SDL_GetTicks() - frame_start;
+            if(frame_time < frame_ms) SDL_Delay(frame_ms - frame_time);
         }
+        return 0;
+    }
 
+    // sets pixel at {x, y} of gui's internal buffer to color, {x, y} being in image coordinates
+    int gui_set_px(int x, int y, rgb24_t color){
         // check if {x, y} in bounds
-        if(x < 0 || x >= gui_width ||
-           y < 0 || y >= gui_height){
+        if(x < 0 || x >= image_width ||
+           y < 0 || y >= image_height){
             return 1;
         }
 
         // set pixel
-        SDL_LockSurface(gui_surface);
-        ((uint32_t *)gui_surface->pixels)[x + y * gui_width] = (color.r << 16) |
-                                                               (color.g <<  8) |
-                                                               (color.b <<  0);
-        SDL_UnlockSurface(gui_surface);
-
-        if(mtx_unlock(&render_mtx) != thrd_success){
-            VERRPRINT(0, "Failed to unlock render_mtx");
-            return 1;
-        }
+        x /= gui_downscale;
+        y /= gui_downscale;
+        gui_pixels[x + y * gui_width] = (color.r << 16) |
+                                        (color.g <<  8) |
+                                        (color.b <<  0);
+        mark_dirty(x, y, 1, 1);
+
         return 0;
     }
-    // renders texture to gui's internal buffer at {x, y}
+    // renders texture to gui's internal buffer at {x, y}, {x, y} being in image coordinates
+    // when downscaled, every gui pixel whose top left image pixel lies inside texture becomes the average of the texture pixels it covers
     // returns amount of pixels not rendered
+    // no lock is taken, callers writing to overlapping areas at the same time get whichever write lands last
     int gui_render_texture(int x, int y, const rgb24_texture_t *texture){
-        if(mtx_lock(&render_mtx) != thrd_success){
-            VERRPRINT(0, "Failed to lock render_mtx");
-            return 1;
-        }
+        // clip to image
+        int x_min = x,
+            y_min = y,
+            x_max = x + texture->width,
+            y_max = y + texture->height;
+        if(x_min < 0)            x_min = 0;
+        if(y_min < 0)            y_min = 0;
+        if(x_max > image_width)  x_max = image_width;
+        if(y_max > image_height) y_max = image_height;
+        if(x_max <= x_min || y_max <= y_min) return texture->width * texture->height;
+        const int outp = texture->width * texture->height - (x_max - x_min) * (y_max - y_min);
 
-        int outp = 0;
+        // gui pixels this texture is responsible for
+        const int f      = gui_downscale,
+                  gx_min = (x_min + f - 1) / f,
+                  gy_min = (y_min + f - 1) / f,
+                  gx_max = (x_max + f - 1) / f,
+                  gy_max = (y_max + f - 1) / f;
 
         // render texture
-        SDL_LockSurface(gui_surface);
-        for(int tex_y = 0; tex_y < texture->height; ++tex_y){
-            if(tex_y + y < 0 || tex_y + y >= gui_height){
-                outp += texture->width;
-                continue;
-            }
-            for(int tex_x = 0; tex_x < texture->width; ++tex_x){
-                if(tex_x + x < 0 || tex_x + x >= gui_width){
-                    ++outp;
-                    continue;
+        for(int gy = gy_min; gy < gy_max; ++gy){
+            const int sy_max = (gy * f + f < y_max) ? gy * f + f : y_max;
+            for(int gx = gx_min; gx < gx_max; ++gx){
+                const int sx_max = (gx * f + f < x_max) ? gx * f + f : x_max;
+                unsigned r = 0,
+                         g = 0,
+                         b = 0;
+                for(int sy = gy * f; sy < sy_max; ++sy){
+                    for(int sx = gx * f; sx < sx_max; ++sx){
+                        const rgb24_t texture_px = texture->data[(sx - x) + (sy - y) * texture->width];
+                        r += texture_px.r;
+                        g += texture_px.g;
+                        b += texture_px.b;
+                    }
                 }
-                const rgb24_t texture_px = texture->data[tex_x + tex_y * texture->width];
-                ((uint32_t *)gui_surface->pixels)[(tex_x + x) + (tex_y + y) * gui_width] = (texture_px.r << 16) |
-                                                                                           (texture_px.g <<  8) |
-                                                                                           (texture_px.b <<  0);
+                const unsigned count = (sx_max - gx * f) * (sy_max - gy * f);
+                gui_pixels[gx + gy * gui_width] = ((r / count) << 16) |
+                                                  ((g / count) <<  8) |
+                                                  ((b / count) <<  0);
             }
         }
-        SDL_UnlockSurface(gui_surface);
 
-        if(mtx_unlock(&render_mtx) != thrd_success){
-            VERRPRINT(0, "Failed to unlock render_mtx");
-            return 1;
-        }
+        // publish the change, only after the pixels are written so the next present picks them up
+        mark_dirty(gx_min, gy_min, gx_max - gx_min, gy_max - gy_min);
+
         return outp;
     }
+
+    // marks all blocks overlapping the rectangle {x, y, width, height} (in gui coordinates) as dirty
+    static void mark_dirty(int x, int y, int width, int height){
+        // clip to gui
+        if(x < 0){
+            width += x;
+            x = 0;
+        }
+        if(y < 0){
+            height += y;
+            y = 0;
+        }
+        if(x + width  > gui_width)  width  = gui_width  - x;
+        if(y + height > gui_height) height = gui_height - y;
+        if(width <= 0 || height <= 0) return;
+
+        // mark blocks
+        for(int dy = y / DIRTY_BLOCK_SIZE; dy <= (y + height - 1) / DIRTY_BLOCK_SIZE; ++dy){
+            for(int dx = x / DIRTY_BLOCK_SIZE; dx <= (x + width - 1) / DIRTY_BLOCK_SIZE; ++dx){
+                atomic_store(&gui_dirty[dx + dy * dirty_width], 1);
+            }
+        }
+    }
 #else
     #include <stdio.h>
 
     // dummy implementation to give warnings
+    int gui_init(void){
+        fprintf(stderr, "Warning: gui_init() not supported at compiletime\n");
+        return 1;
+    }
     int gui_setup(int width, int height, int scalar){
         fprintf(stderr, "Warning: gui_setup() not supported at compiletime\n");
         int a = width + height + scalar; a = a + a; // to keep out some warnings
@@ -254,6 +403,11 @@
         fprintf(stderr, "Warning: gui_present() not supported at compiletime\n");
         return 1;
     }
+    int gui_run(atomic_int *running, atomic_int *threads_left){
+        fprintf(stderr, "Warning: gui_run() not supported at compiletime\n");
+        int a = atomic_load(running) + atomic_load(threads_left); a = a + a; // to keep out some warnings
+        return 1;
+    }
     int gui_set_px(int x, int y, rgb24_t color){
         fprintf(stderr, "Warning: gui_set_px() not supported at compiletime\n");
         int a = x + y + color.r; a = a + a; // to keep out some warnings
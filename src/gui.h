@@ -38,21 +38,44 @@
     #define GUI_SUPPORTED 0
 #endif
 
+#include <stdatomic.h>
 #include "rgb24.h"
 #include "texture.h"
 
+// maximum amount of times per second gui_run() presents
+#ifndef GUI_FPS
+    #define GUI_FPS 60
+#endif
+
+// largest preview shown, images bigger than this (or the display) are shown downscaled
+#ifndef GUI_MAX_WIDTH
+    #define GUI_MAX_WIDTH 1920
+#endif
+#ifndef GUI_MAX_HEIGHT
+    #define GUI_MAX_HEIGHT 1080
+#endif
+
+// initializes SDL, which doesn't need to know the image yet and so can be done while it's still loading
+// called by gui_setup() if it wasn't already, has to be called from the same thread as gui_setup()
+int gui_init(void);
 // sets up gui to render an image of size {width, height} and multiply its size by scalar for showing
+// if the image is bigger than the display or GUI_MAX_WIDTH x GUI_MAX_HEIGHT, it is shown downscaled by an integer factor
 int gui_setup(int width, int height, int scalar);
-// frees everything gui uses
+// frees everything gui uses, does nothing if gui_init() didn't succeed
 void gui_free(void);
 
 // renders current visuals to the window
 int gui_present(void);
+// presents and handles events until *threads_left reaches 0 or *running is set to 0
+// sets *running to 0 if the user cancels, has to be called from the thread gui_setup() was called from
+int gui_run(atomic_int *running, atomic_int *threads_left);
 
-// sets pixel at {x, y} of gui's internal buffer to color
+// sets pixel at {x, y} of gui's internal buffer to color, {x, y} being in image coordinates
 int gui_set_px(int x, int y, rgb24_t color);
-// renders texture to gui's internal buffer at {x, y}
+// renders texture to gui's internal buffer at {x, y}, {x, y} being in image coordinates
+// when downscaled, every gui pixel whose top left image pixel lies inside texture becomes the average of the texture pixels it covers
 // returns amount of pixels not rendered
+// no lock is taken, callers writing to overlapping areas at the same time get whichever write lands last
 int gui_render_texture(int x, int y, const rgb24_texture_t *texture);
 
 #endif
@@ -33,18 +33,51 @@
 
 #include "load_png.h"
 
+#include <limits.h>
 #include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include "map_file.h"
+#include "netpbm.h"
 #include "print.h"
+#include "qoi.h"
 #include "stb_image.h"
 #include "stb_image_write.h"
 #include "texture.h"
 
 // returns whether or not str ends with match
 static int strendswith(const char *restrict str, const char *restrict match);
+// returns whether or not name ends with ending (like ".png"), or is ending without the dot
+static int has_ending(const char *restrict name, const char *restrict ending);
+// decodes the image in file, in any format stb_image or netpbm.c and qoi.c understand, into texture and unmaps file
+static int decode_image(rgb24_texture_t *restrict texture, mapped_file_t *file, const char *name);
+// writes size bytes of data to the stream in a struct write_stream for stb_image_write
+static void write_stream(void *context, void *data, int size);
+
+// where stb_image_write writes to with write_stream()
+struct write_stream{
+    FILE *stream;
+    int   failed;
+};
 
 // loads texture from png_path
+// a png_path of "-" reads the image from stdin, in which case the format is recognized by its contents instead of its ending
 int load_png(rgb24_texture_t *restrict texture, const char *png_path){
+    // stdin
+    if(!strcmp(png_path, "-")){
+        mapped_file_t file;
+        if(map_file(&file, png_path)){
+            VERRPRINT(0, "Failed to read image from stdin");
+            return 1;
+        }
+        return decode_image(texture, &file, "stdin");
+    }
+
+    // formats read without stb_image
+    if(strendswith(png_path, ".ppm") || strendswith(png_path, ".pnm") || strendswith(png_path, ".pam")) return load_netpbm(texture, png_path);
+    if(strendswith(png_path, ".qoi"))                                                                   return load_qoi(texture, png_path);
+
     // load image
     int img_width, img_height;
     unsigned char *img_data = stbi_load(png_path, &img_width, &img_height, NULL, STBI_rgb);
@@ -71,20 +104,48 @@ int load_png(rgb24_texture_t *restrict texture, const char *png_path){
     stbi_image_free(img_data);
     return 0;
 }
+// loads texture from png_path like load_png(), but without ever keeping the file mapped, so it can't crash if the file changes meanwhile
+// for processes that keep running while users write to the files they load
+int load_png_owned(rgb24_texture_t *restrict texture, const char *png_path){
+    // stb_image reads through stdio anyways, only the formats decoded from a mapping have to be read first
+    if(!strendswith(png_path, ".ppm") && !strendswith(png_path, ".pnm") && !strendswith(png_path, ".pam") && !strendswith(png_path, ".qoi")){
+        return load_png(texture, png_path);
+    }
+    mapped_file_t file;
+    if(read_file(&file, png_path)){
+        VERRPRINTF(0, "Failed to read %s", png_path);
+        return 1;
+    }
+    return strendswith(png_path, ".qoi") ? decode_qoi(texture, &file, png_path) : decode_netpbm(texture, &file, png_path);
+}
 // saves texture at png_path
+// a png_path of "-" writes a png to stdout
 int save_png(const char *png_path, const rgb24_texture_t *restrict texture){
+    return save_png_as(png_path, NULL, texture);
+}
+// saves texture at png_path, in format (an ending like ".qoi" or "qoi") instead of the one png_path ends with if format isn't NULL
+// a png_path of "-" writes to stdout, as a png unless format says otherwise
+int save_png_as(const char *png_path, const char *format, const rgb24_texture_t *restrict texture){
     // get image format
+    const char *name = format ? format : !strcmp(png_path, "-") ? ".png" : png_path;
     enum {IF_PNG, IF_JPG, IF_BMP} image_format;
-    if(strendswith(png_path, ".png"))       image_format = IF_PNG;
-    else if(strendswith(png_path, ".jpg") ||
-            strendswith(png_path, ".jpeg")) image_format = IF_JPG;
-    else if(strendswith(png_path, ".bmp"))  image_format = IF_BMP;
+    if(has_ending(name, ".png"))       image_format = IF_PNG;
+    else if(has_ending(name, ".jpg") ||
+            has_ending(name, ".jpeg")) image_format = IF_JPG;
+    else if(has_ending(name, ".bmp"))  image_format = IF_BMP;
+    // formats written without stb_image_write
+    else if(has_ending(name, ".ppm"))  return save_ppm(png_path, texture);
+    else if(has_ending(name, ".pam"))  return save_pam(png_path, texture);
+    else if(has_ending(name, ".qoi"))  return save_qoi(png_path, texture);
     else{
         VERRPRINT(0, "Image format not recognized");
-        VPRINT(1, "If you are encountering this, please change the ending of your output file to one of\n"
+        VPRINT(1, "If you are encountering this, please change the ending of your output file (or the format you gave) to one of\n"
                   " .png\n"
                   " .jpg\n"
-                  " .bmp\n");
+                  " .bmp\n"
+                  " .ppm\n"
+                  " .pam\n"
+                  " .qoi\n");
         return 1;
     }
 
@@ -100,24 +161,29 @@ int save_png(const char *png_path, const rgb24_texture_t *restrict texture){
         img_data[3 * i + 2] = texture->data[i].b;
     }
 
-    // write data
+    // write data, to stdout through write_stream() for "-"
+    struct write_stream stream = {stdout, 0};
+    const int to_stdout = !strcmp(png_path, "-");
     switch(image_format){
         case IF_PNG:
-            if(!stbi_write_png(png_path, texture->width, texture->height, STBI_rgb, img_data, texture->width * 3)){
+            if(to_stdout ? !stbi_write_png_to_func(&write_stream, &stream, texture->width, texture->height, STBI_rgb, img_data, texture->width * 3) || stream.failed :
+                           !stbi_write_png(png_path, texture->width, texture->height, STBI_rgb, img_data, texture->width * 3)){
                 VERRPRINT(0, "Failed to save png");
                 free(img_data);
                 return 1;
             }
             break;
         case IF_JPG:
-            if(!stbi_write_jpg(png_path, texture->width, texture->height, STBI_rgb, img_data, 100)){
+            if(to_stdout ? !stbi_write_jpg_to_func(&write_stream, &stream, texture->width, texture->height, STBI_rgb, img_data, 100) || stream.failed :
+                           !stbi_write_jpg(png_path, texture->width, texture->height, STBI_rgb, img_data, 100)){
                 VERRPRINT(0, "Failed to save jpg");
                 free(img_data);
                 return 1;
             }
             break;
         case IF_BMP:
-            if(!stbi_write_bmp(png_path, texture->width, texture->height, STBI_rgb, img_data)){
+            if(to_stdout ? !stbi_write_bmp_to_func(&write_stream, &stream, texture->width, texture->height, STBI_rgb, img_data) || stream.failed :
+                           !stbi_write_bmp(png_path, texture->width, texture->height, STBI_rgb, img_data)){
                 VERRPRINT(0, "Failed to save bmp");
                 free(img_data);
                 return 1;
@@ -128,6 +194,11 @@ int save_png(const char *png_path, const rgb24_texture_t *restrict texture){
             free(img_data);
             return 1;
     }
+    if(to_stdout && fflush(stdout)){
+        VERRPRINT(0, "Failed to flush stdout");
+        free(img_data);
+        return 1;
+    }
 
     // clean and return
     free(img_data);
@@ -144,3 +215,50 @@ static int strendswith(const char *restrict str, const char *restrict match){
     }
     return 1;
 }
+// returns whether or not name ends with ending (like ".png"), or is ending without the dot
+static int has_ending(const char *restrict name, const char *restrict ending){
+    return strendswith(name, ending) || !strcmp(name, ending + 1);
+}
+// decodes the image in file, in any format stb_image or netpbm.c and qoi.c understand, into texture and unmaps file
+static int decode_image(rgb24_texture_t *restrict texture, mapped_file_t *file, const char *name){
+    // formats read without stb_image, recognized by their magic numbers
+    if(file->size >= 2 && file->data[0] == 'P' && (file->data[1] == '6' || file->data[1] == '7')) return decode_netpbm(texture, file, name);
+    if(file->size >= 4 && !memcmp(file->data, "qoif", 4))                                       return decode_qoi(texture, file, name);
+
+    // load image
+    if(file->size > INT_MAX){
+        VERRPRINTF(0, "%s is too large", name);
+        unmap_file(file);
+        return 1;
+    }
+    int img_width, img_height;
+    unsigned char *img_data = stbi_load_from_memory(file->data, file->size, &img_width, &img_height, NULL, STBI_rgb);
+    unmap_file(file);
+    if(!img_data){
+        VERRPRINTF(0, "Failed to load image from %s", name);
+        return 1;
+    }
+
+    // create texture
+    if(rgb24_texture_create(texture, img_width, img_height)){
+        VERRPRINT(0, "Failed to create texture");
+        stbi_image_free(img_data);
+        return 1;
+    }
+
+    // copy data
+    for(int i = 0; i < img_width * img_height; ++i){
+        texture->data[i].r = img_data[i * 3 + 0];
+        texture->data[i].g = img_data[i * 3 + 1];
+        texture->data[i].b = img_data[i * 3 + 2];
+    }
+
+    // clean and return
+    stbi_image_free(img_data);
+    return 0;
+}
+// writes size bytes of data to the stream in a struct write_stream for stb_image_write
+static void write_stream(void *context, void *data, int size){
+    struct write_stream *stream = context;
+    if(!stream->failed && fwrite(data, 1, size, stream->stream) != (size_t)size) stream->failed = 1;
+}
@@ -37,8 +37,16 @@
 #include "texture.h"
 
 // loads texture from png_path
+// a png_path of "-" reads the image from stdin, in which case the format is recognized by its contents instead of its ending
 int load_png(rgb24_texture_t *restrict texture, const char *png_path);
+// loads texture from png_path like load_png(), but without ever keeping the file mapped, so it can't crash if the file changes meanwhile
+// for processes that keep running while users write to the files they load
+int load_png_owned(rgb24_texture_t *restrict texture, const char *png_path);
 // saves texture at png_path
+// a png_path of "-" writes a png to stdout
 int save_png(const char *png_path, const rgb24_texture_t *restrict texture);
+// saves texture at png_path, in format (an ending like ".qoi" or "qoi") instead of the one png_path ends with if format isn't NULL
+// a png_path of "-" writes to stdout, as a png unless format says otherwise
+int save_png_as(const char *png_path, const char *format, const rgb24_texture_t *restrict texture);
 
 #endif
@@ -35,36 +35,57 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
-#if defined(_WIN32)
-    #if defined(__MINGW32__)
-        #include <windows.h> // for whatever reason its with a non capital 'W' with mingw, so ig ill say that extra :333
-    #else
-        #include <Windows.h>
-    #endif
-#elif defined(__unix__)
-    #include <time.h>
-#endif
 #include "application.h"
 #include "atlas.h"
+#include "builtin_configs.h"
+#include "cache.h"
 #include "get_threads.h"
 #include "gui.h"
 #include "load_png.h"
 #include "print.h"
 #include "rgb24.h"
+#include "serve.h"
+#include "shard.h"
+#include "sweep.h"
 #include "texture.h"
+#include "tilize.h"
+#include "timing.h"
+#include "watch.h"
 #if GUI_SUPPORTED
     #include <SDL2/SDL.h>
 #endif
-
-typedef long long unsigned ms_t;
+#if defined(_WIN32)
+    #include <fcntl.h>
+    #include <io.h>
+#endif
 
 static const char *help_msg = "Usage:\n"
-                              " Tilize [[options]] [file]  | Tilizes [file] with [options]\n"
+                              " Tilize [[options]] [file]  | Tilizes [file] with [options], `-` reads it from stdin\n"
                               " Tilize help                | Show this message\n"
-                              "\n"
-                              "Options:\n"
-                              " -o [file]                  | Save result to [file]\n"
+                          #if SERVE_SUPPORTED
+                              " Tilize serve [[options]]   | Keep configurations loaded and tilize whatever clients ask for\n"
+                              "                            | on the unix socket given with `--socket`\n"
+                              " Tilize client [[options]] [file]\n"
+                              "                            | Ask the server on the socket given with `--socket` to tilize [file]\n"
+                          #endif
+                          #if WATCH_SUPPORTED
+                              " Tilize watch [[options]] [directory]\n"
+                              "                            | Tilize every image written into [directory] into the directory given with `-o`\n"
+                          #endif
+                              " Tilize compile-config -o [output] [file]\n"
+                              "                            | Compile the configuration [file] into [output], which loads faster when used with `-c`\n"
+                              " Tilize merge [[options]] [files]\n"
+                              "                            | Put the tile maps [files] made with `--shard` together into the image given with `-o`\n"
+                              "\n";
+// split from help_msg, since C only promises string literals of up to 4095 characters
+static const char *help_options_msg = "Options:\n"
+                              " -o [file]                  | Save result to [file], `-` writes it to stdout\n"
                               " -c [file]                  | Use [file] as configuration\n"
+                              "                            | if given multiple times, [file] is tilized with each of them into `-o`,\n"
+                              "                            | in which `%s` is replaced by the name of the configuration\n"
+                          #if BUILTIN_CONFIGS_SUPPORTED
+                              " -c builtin:[name]          | Use the configuration [name] from resources/ built into Tilize\n"
+                          #endif
                           #if GET_THREADS_SUPPORTED
                               " -j[=number]                | Use multiple threads ([number] if provided, otherwise maximum amount available)\n"
                           #else
@@ -79,6 +100,31 @@ static const char *help_msg = "Usage:\n"
                               "                            | 1 (default) : Print errors and warnings\n"
                               "                            | 2 (`-v`)    : Print errors, warnings and subprocess times\n"
                               " -y                         | Automatically answer `yes` to all questions directed at the user\n"
+                              " --format=[ending]          | Save the result as [ending] (like `qoi`) instead of what the file given with `-o` ends with\n"
+                              "                            | (`png` for `-`)\n"
+                              " --deadline=[ms]            | Give every tile a rough result first, then improve the worst ones until [ms] milliseconds are up\n"
+                              " --quality=[percent]        | Allow results up to 100 / [percent] times worse than the best ones (100 by default) to search faster,\n"
+                              "                            | and print how much worse they are on a sample of tiles (with fewer than 128 patterns, only\n"
+                              "                            | [percent] of the colors closest to each tile are tried instead, without a limit on how much worse it gets)\n"
+                              " --shard=[i]/[n]            | Only tilize the [i]th of [n] bands of tile rows (counting from 0) and save them as a tile map to `-o`,\n"
+                              "                            | for `merge` to put together once all bands are done\n"
+                              " --checkpoint=[seconds]     | Save finished tiles to `[file from -o].checkpoint` every [seconds] seconds\n"
+                              " --resume                   | Keep the tiles saved in `[file from -o].checkpoint` (if it exists) instead of searching them again\n"
+                              " --save-tiles=[file]        | Also save which pattern and colors each tile got as a tile map to [file]\n"
+                              " --previous=[file]          | Only tilize the tiles that changed since [file] (a result image or tile map) was made,\n"
+                              "                            | given with `--old-input` and / or `--dirty`, and take the rest from [file]\n"
+                              " --old-input=[file]         | The image `--previous` was made from, tiles with different pixels are tilized again\n"
+                              " --dirty=[x,y,w,h[:...]]    | Rectangles that changed since `--previous` was made, tiles touching them are tilized again\n"
+                              " --roi=[x,y,w,h[:...]]      | Only tilize the tiles touching these rectangles, everything else is copied from the input\n"
+                              " --mask=[file]              | Only tilize the tiles touching white pixels of the image [file], everything else is copied from the input\n"
+                          #if CACHE_SUPPORTED
+                              " --cache=[directory]        | Keep results in [directory] and reuse them when the same image is tilized with the same configuration again\n"
+                              " --cache-size=[MiB]         | Remove the least recently used results once the cache is larger than [MiB] (" CACHE_DEFAULT_MIB_STRING " by default)\n"
+                          #endif
+                          #if SERVE_SUPPORTED
+                              " --socket [path]            | Socket used by `serve` and `client`\n"
+                              " --raw                      | Make `client` send the pixels of [file] instead of its path\n"
+                          #endif
                               "\n"
                               "If the same option is provided multiple times, the last one is used.\n"
                               "\n"
@@ -86,31 +132,55 @@ static const char *help_msg = "Usage:\n"
                               "\n"
                               "Copyright (c) 2024 rue04, licensed under the MIT License\n";
 
+// loading the input image, run on the pool during setup
+struct load_input_task{
+    const char      *path;
+    rgb24_texture_t *image;
+    ms_t             start_ms,
+                     end_ms;
+};
+// setting up the application (mainly loading the configuration), run on the pool during setup
+struct application_setup_task{
+    const flag_config_t *flag_config;
+    thread_pool_t       *pool;
+    ms_t                 start_ms,
+                         end_ms;
+};
+
 // returns whether or not an option with the name opt_name was provided, if so puts its index into index
 static int option_provided(int argc, const char **argv, const char *restrict opt_name, int *restrict index);
 // makes a copy of src and returns it
 static char *strdup_exceptmyversionsobettercauseitisntc23exclusive(const char *restrict src);
-// gets current time in ms
-static ms_t current_ms(void);
+// gets the amount of threads requested with `-j`, returns 1 if it's invalid
+static int thread_count_option(int argc, const char **argv, int *restrict num_threads);
+// loads the input image of a struct load_input_task
+static int load_input_task(void *task_void);
+// sets up the application for a struct application_setup_task
+static int application_setup_task(void *task_void);
 
 int main(int argc, const char **argv){
     int return_code = EXIT_SUCCESS;
-    tilize_config_t tilize_config = TILIZE_CONFIG_NULL;
-    flag_config_t   flag_config   = FLAG_CONFIG_NULL;
+    flag_config_t flag_config = FLAG_CONFIG_NULL;
     int option_index;
     int auto_answer_y = 0;
     ms_t flag_start_ms        = 0,
-         load_input_start_ms  = 0,
+         setup_start_ms       = 0,
          #if GUI_SUPPORTED
              gui_start_ms     = 0,
+             gui_end_ms       = 0,
          #endif
          application_start_ms = 0,
          deinit_start_ms      = 0,
          tilize_end_ms        = 0;
 
+    // make configurations built into Tilize available
+    #if BUILTIN_CONFIGS_SUPPORTED
+        tilize_set_builtins(builtin_configs, num_builtin_configs);
+    #endif
+
     // check if the user used too few arguments or if help is requested
     if(argc < 2 || option_provided(argc, argv, "help", NULL) || option_provided(argc, argv, "--help", NULL) || option_provided(argc, argv, "-h", NULL)){
-        printf("%s", help_msg);
+        printf("%s%s", help_msg, help_options_msg);
         return EXIT_SUCCESS;
     }
 
@@ -128,11 +198,65 @@ int main(int argc, const char **argv){
         }
     }
 
+    // -o - option, the result goes to stdout, so everything else printed has to go to stderr
+    if(option_provided(argc, argv, "-o", &option_index) && argc > option_index + 1 && !strcmp(argv[option_index + 1], "-")){
+        set_print_stream(stderr);
+        #if defined(_WIN32)
+            _setmode(_fileno(stdout), _O_BINARY);
+        #endif
+    }
+    #if defined(_WIN32)
+        // [file] of `-`, the input comes from stdin
+        if(!strcmp(argv[argc - 1], "-")) _setmode(_fileno(stdin), _O_BINARY);
+    #endif
+
     // flag_start_ms (tilize_start_ms), only after `-v` flag so it doesnt print if `-v=-1` is specified
     if(get_verbosity() >= 2){
         flag_start_ms = current_ms();
     }
 
+    #if SERVE_SUPPORTED
+        // serve and client commands
+        if(!strcmp(argv[1], "serve") || !strcmp(argv[1], "client")){
+            if(!option_provided(argc, argv, "--socket", &option_index) || argc <= option_index + 1){
+                VPRINT(1, "Please provide the socket to use with `--socket [path]`\n");
+                return EXIT_FAILURE;
+            }
+            const char *socket_path = argv[option_index + 1];
+            if(!strcmp(argv[1], "serve")){
+                if(thread_count_option(argc, argv, &flag_config.num_threads)) return EXIT_FAILURE;
+                return serve_run(socket_path, flag_config.num_threads) ? EXIT_FAILURE : EXIT_SUCCESS;
+            }
+            const char *config_path = NULL;
+            if(option_provided(argc, argv, "-c", &option_index)){
+                if(argc <= option_index + 1){
+                    VPRINT(1, "Cannot use a config because `-c` was given as the last argument\n");
+                    return EXIT_FAILURE;
+                }
+                config_path = argv[option_index + 1];
+            }
+            if(!option_provided(argc, argv, "-o", &option_index) || argc <= option_index + 1){
+                VPRINT(1, "Please provide where the server should save the result with `-o [file]`\n");
+                return EXIT_FAILURE;
+            }
+            const int send_raw = option_provided(argc, argv, "--raw", NULL);
+            return serve_client(socket_path, config_path, argv[argc - 1], argv[option_index + 1], send_raw) ? EXIT_FAILURE : EXIT_SUCCESS;
+        }
+    #endif
+
+    // compile-config command
+    if(!strcmp(argv[1], "compile-config")){
+        if(!option_provided(argc, argv, "-o", &option_index) || argc <= option_index + 1){
+            VPRINT(1, "Please provide where the compiled configuration should be saved with `-o [file]`\n");
+            return EXIT_FAILURE;
+        }
+        if(tilize_context_compile(argv[argc - 1], argv[option_index + 1])){
+            VERRPRINT(0, "Failed to compile configuration");
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
     // -y option, auto answer yes
     if(option_provided(argc, argv, "-y", &option_index)) auto_answer_y = 1;
     else                                                 auto_answer_y = 0;
@@ -144,91 +268,177 @@ int main(int argc, const char **argv){
             VPRINT(1, "Cannot try opening config_file because `-c` was given as the last argument");
             return EXIT_FAILURE;
         }
-        FILE *config_file = fopen(argv[option_index + 1], "r");
-        if(!config_file){
-            VERRPRINT(0, "Failed to open config_file");
+        flag_config.config_path = strdup_exceptmyversionsobettercauseitisntc23exclusive(argv[option_index + 1]);
+        if(!flag_config.config_path){
+            VERRPRINT(0, "Failed to duplicate `-c` path to flag_config.config_path");
             return EXIT_FAILURE;
         }
-        if(fseek(config_file, 0, SEEK_END)){
-            VERRPRINT(0, "Failed to seek to end of config_file");
-            fclose(config_file);
+    }
+    else{
+        // config file not provided, default one is used
+        flag_config.config_path = NULL;
+    }
+
+    // -j option, thread count
+    if(thread_count_option(argc, argv, &flag_config.num_threads)) return EXIT_FAILURE;
+
+    // --deadline= option, time limit
+    if(option_provided(argc, argv, "--deadline", &option_index)){
+        // option provided
+        if(strlen(argv[option_index]) <= 11 || argv[option_index][10] != '=' || atoi(&argv[option_index][11]) <= 0){
+            VPRINT(1, "Please give `--deadline` a positive number of milliseconds, like `--deadline=200`\n");
             return EXIT_FAILURE;
         }
-        long config_file_size = ftell(config_file);
-        if(config_file_size == -1L){
-            VERRPRINT(0, "Failed to tell position in config_file");
-            fclose(config_file);
+        flag_config.deadline_ms = atoi(&argv[option_index][11]);
+    }
+
+    // --quality= option, percentage of patterns tried
+    if(option_provided(argc, argv, "--quality", &option_index)){
+        // option provided
+        if(strlen(argv[option_index]) <= 10 || argv[option_index][9] != '=' || atoi(&argv[option_index][10]) <= 0 || atoi(&argv[option_index][10]) > 100){
+            VPRINT(1, "Please give `--quality` a percentage from 1 to 100, like `--quality=25`\n");
             return EXIT_FAILURE;
         }
-        rewind(config_file);
-        char *config_text = calloc(config_file_size + 16, sizeof(char));
-        if(!config_text){
-            VERRPRINT(0, "Failed to allocate config_text");
-            fclose(config_file);
-            return EXIT_FAILURE;
+        flag_config.quality = atoi(&argv[option_index][10]);
+    }
+
+    // --shard= option, part of the image to tilize
+    if(option_provided(argc, argv, "--shard", &option_index)){
+        // option provided
+        char *shard_end;
+        long  shard_index = -1,
+              shard_count = 0;
+        if(strlen(argv[option_index]) > 8 && argv[option_index][7] == '='){
+            shard_index = strtol(&argv[option_index][8], &shard_end, 10);
+            if(*shard_end == '/') shard_count = strtol(shard_end + 1, &shard_end, 10);
+            if(*shard_end != 0) shard_count = 0;
         }
-        fread(config_text, sizeof(char), config_file_size + 8, config_file);
-        fclose(config_file);
-        if(tilize_config_deserialize(&tilize_config, config_text)){
-            VERRPRINT(0, "Failed to deserialize config");
-            free(config_text);
+        if(shard_count < 1 || shard_count > INT_MAX || shard_index < 0 || shard_index >= shard_count){
+            VPRINT(1, "Please give `--shard` which of how many bands to tilize, like `--shard=0/4`\n");
+            free(flag_config.config_path);
             return EXIT_FAILURE;
         }
-        free(config_text);
+        flag_config.shard_index = shard_index;
+        flag_config.shard_count = shard_count;
+    }
 
-        flag_config.config_path = strdup_exceptmyversionsobettercauseitisntc23exclusive(argv[option_index + 1]);
-        if(!flag_config.config_path){
-            VERRPRINT(0, "Failed to duplicate `-c` path to flag_config.config_path");
+    // --checkpoint= option, how often to save finished tiles
+    if(option_provided(argc, argv, "--checkpoint", &option_index)){
+        // option provided
+        if(strlen(argv[option_index]) <= 13 || argv[option_index][12] != '=' || atoi(&argv[option_index][13]) <= 0){
+            VPRINT(1, "Please give `--checkpoint` a positive number of seconds, like `--checkpoint=60`\n");
+            free(flag_config.config_path);
             return EXIT_FAILURE;
         }
+        flag_config.checkpoint_s = atoi(&argv[option_index][13]);
     }
-    else{
-        // config file not provided
-        flag_config.config_path = NULL;
 
-        tilize_config.pattern_path = NULL;
-        tilize_config.tile_width   = 4;
-        tilize_config.tile_height  = 4;
-        tilize_config.num_colors   = 2;
-        tilize_config.colors       = malloc(2 * sizeof(*tilize_config.colors));
-        if(!tilize_config.colors){
-            VERRPRINT(0, "Failed to allocate colors");
+    // --resume option, continue from checkpoint
+    if(option_provided(argc, argv, "--resume", &option_index)) flag_config.resume = 1;
+
+    // --save-tiles= option, where to save the tile map
+    if(option_provided(argc, argv, "--save-tiles=", &option_index)) flag_config.tile_map_path = &argv[option_index][13];
+
+    // --previous=, --old-input= and --dirty= options, incremental tilizing
+    if(option_provided(argc, argv, "--previous=", &option_index))  flag_config.previous_path  = &argv[option_index][11];
+    if(option_provided(argc, argv, "--old-input=", &option_index)) flag_config.old_input_path = &argv[option_index][12];
+    if(option_provided(argc, argv, "--dirty=", &option_index))     flag_config.dirty_rects    = &argv[option_index][8];
+    #if CACHE_SUPPORTED
+        // --cache= and --cache-size= options, result cache
+        if(option_provided(argc, argv, "--cache=", &option_index)) flag_config.cache_dir = &argv[option_index][8];
+        if(option_provided(argc, argv, "--cache-size", &option_index)){
+            // option provided
+            if(strlen(argv[option_index]) <= 13 || argv[option_index][12] != '=' || atoi(&argv[option_index][13]) <= 0){
+                VPRINT(1, "Please give `--cache-size` a positive number of MiB, like `--cache-size=512`\n");
+                free(flag_config.config_path);
+                return EXIT_FAILURE;
+            }
+            flag_config.cache_mib = atoi(&argv[option_index][13]);
+        }
+    #endif
+
+    // --format= option, format of the output
+    if(option_provided(argc, argv, "--format=", &option_index)) flag_config.file_outp_format = &argv[option_index][9];
+
+    // --roi= and --mask= options, part of the image to tilize
+    if(option_provided(argc, argv, "--roi=", &option_index))  flag_config.roi       = &argv[option_index][6];
+    if(option_provided(argc, argv, "--mask=", &option_index)) flag_config.mask_path = &argv[option_index][7];
+
+    if(flag_config.previous_path && !flag_config.old_input_path && !flag_config.dirty_rects){
+        VPRINT(1, "Please tell `--previous` what changed with `--old-input=[file]` or `--dirty=[x,y,w,h]`\n");
+        free(flag_config.config_path);
+        return EXIT_FAILURE;
+    }
+
+    // multiple -c options, sweep over configurations
+    int num_configs = 0;
+    for(int i = 1; i < argc - 1; ++i) num_configs += !strcmp(argv[i], "-c");
+    if(num_configs > 1){
+        if(!option_provided(argc, argv, "-o", &option_index) || argc <= option_index + 1 || !strstr(argv[option_index + 1], "%s")){
+            VPRINT(1, "Please provide where results should be saved with `-o [file]`, with `%%s` in [file] being replaced by the name of each configuration\n");
+            free(flag_config.config_path);
             return EXIT_FAILURE;
         }
-        tilize_config.colors[0]    = RGB24(0x00,0x00,0x00);
-        tilize_config.colors[1]    = RGB24(0xff,0xff,0xff);
-        tilize_config.bckg_color   = -1;
-        tilize_config.forg_color   = -1;
+        // options about parts of the image or other runs only make sense for one configuration
+        if(flag_config.shard_count > 0 || flag_config.checkpoint_s > 0 || flag_config.resume || flag_config.previous_path || flag_config.tile_map_path ||
+           flag_config.roi || flag_config.mask_path || flag_config.cache_dir){
+            VPRINT(1, "`--shard`, `--checkpoint`, `--resume`, `--previous`, `--save-tiles`, `--roi`, `--mask` and `--cache` can only be used with one configuration\n");
+            free(flag_config.config_path);
+            return EXIT_FAILURE;
+        }
+        const char **config_paths = malloc(num_configs * sizeof(*config_paths));
+        if(!config_paths){
+            VERRPRINT(0, "Failed to allocate config_paths");
+            free(flag_config.config_path);
+            return EXIT_FAILURE;
+        }
+        for(int i = 1, config_i = 0; i < argc - 1; ++i){
+            if(!strcmp(argv[i], "-c")) config_paths[config_i++] = argv[i + 1];
+        }
+        if(sweep_run(argv[argc - 1], config_paths, num_configs, argv[option_index + 1], &flag_config, !auto_answer_y)) return_code = EXIT_FAILURE;
+        free(config_paths);
+        free(flag_config.config_path);
+        return return_code;
     }
 
-    // -j option, thread count
-    if(option_provided(argc, argv, "-j", &option_index)){
-        // option provided
-        if(strlen(argv[option_index]) > 2 && argv[option_index][2] == '='){
-            // -j= option, specified thread count
-            flag_config.num_threads = atoi(&argv[option_index][3]);
-            if(flag_config.num_threads <= 0){
-                VPRINT(1, "Cannot run with non positive amount of threads. Please use a positive number for `-j`\n");
-                return EXIT_FAILURE;
-            }
+    // merge command
+    if(!strcmp(argv[1], "merge")){
+        if(!option_provided(argc, argv, "-o", &option_index) || argc <= option_index + 1){
+            VPRINT(1, "Please provide where the merged image should be saved with `-o [file]`\n");
+            free(flag_config.config_path);
+            return EXIT_FAILURE;
         }
-        else{
-            // -j option, get thread count
-            #if GET_THREADS_SUPPORTED
-                flag_config.num_threads = get_thread_count();
-                if(flag_config.num_threads < 0){
-                    VERRPRINT(0, "Failed to get thread count");
-                    return EXIT_FAILURE;
-                }
-            #else
-                VPRINT(1, "Your system does not currently support the `-j` option. Please use `-j=` instead.\n");
-                return EXIT_FAILURE;
-            #endif
+        // every argument that isn't an option or the value of one is a tile map
+        const char **map_paths = malloc(argc * sizeof(*map_paths));
+        int          num_maps  = 0;
+        if(!map_paths){
+            VERRPRINT(0, "Failed to allocate map_paths");
+            free(flag_config.config_path);
+            return EXIT_FAILURE;
+        }
+        for(int i = 2; i < argc; ++i){
+            if(!strcmp(argv[i], "-c") || !strcmp(argv[i], "-o")) ++i;
+            else if(argv[i][0] != '-' || !strcmp(argv[i], "-")) map_paths[num_maps++] = argv[i];
+        }
+        if(num_maps < 1){
+            VPRINT(1, "Please provide the tile maps to merge\n");
+            return_code = EXIT_FAILURE;
         }
+        else if(shard_merge(map_paths, num_maps, flag_config.config_path, argv[option_index + 1])) return_code = EXIT_FAILURE;
+        free(map_paths);
+        free(flag_config.config_path);
+        return return_code;
     }
-    else{
-        // option not provided
-        flag_config.num_threads = 1;
+
+    // watch command
+    if(!strcmp(argv[1], "watch")){
+        if(!option_provided(argc, argv, "-o", &option_index) || argc <= option_index + 1){
+            VPRINT(1, "Please provide where results should be saved with `-o [directory]`\n");
+            return_code = EXIT_FAILURE;
+        }
+        else if(watch_run(argv[argc - 1], argv[option_index + 1], flag_config.config_path, flag_config.num_threads)) return_code = EXIT_FAILURE;
+        if(flag_config.config_path) free(flag_config.config_path);
+        return return_code;
     }
 
     #if GUI_SUPPORTED
@@ -246,6 +456,8 @@ int main(int argc, const char **argv){
     #endif
 
     // -o option, output file
+    // the questions below are answered on stdin, which can't be done if the input image comes from there
+    const int input_from_stdin = !strcmp(argv[argc - 1], "-");
     if(option_provided(argc, argv, "-o", &option_index)){
         // option provided
         if(argc <= option_index + 1){
@@ -253,10 +465,14 @@ int main(int argc, const char **argv){
             return EXIT_FAILURE;
         }
         flag_config.file_outp_path = argv[option_index + 1];
-        if(!auto_answer_y){
+        if(!auto_answer_y && strcmp(flag_config.file_outp_path, "-")){
             FILE *outp_file_test = fopen(flag_config.file_outp_path, "r");
             if(outp_file_test){
                 fclose(outp_file_test);
+                if(input_from_stdin){
+                    VPRINTF(1, "%s already exists and stdin is taken by the input image, please add `-y` to overwrite it\n", flag_config.file_outp_path);
+                    return EXIT_FAILURE;
+                }
                 printf("Warning: %s already exists. Overwrite (y / N)?\n", flag_config.file_outp_path);
                 char yN = getchar();
                 if(!(yN == 'y' || yN == 'Y')){
@@ -271,6 +487,10 @@ int main(int argc, const char **argv){
         // option not provided
         flag_config.file_outp_path = NULL;
         if(!auto_answer_y && !flag_config.showgui){
+            if(input_from_stdin){
+                VPRINT(1, "Running without any form of output and stdin is taken by the input image, please add `-y` to do so anyways\n");
+                return EXIT_FAILURE;
+            }
             printf("Warning: Running without any form of output. Proceed (y / N)?\n");
             char yN = getchar();
             if(!(yN == 'y' || yN == 'Y')){
@@ -281,64 +501,128 @@ int main(int argc, const char **argv){
         }
     }
 
-    // get load_input_start_ms
+    // get setup_start_ms
     if(get_verbosity() >= 2){
-        load_input_start_ms = current_ms();
-        VPRINTF(2, "Finished parsing flags in %llu ms\n", (long long unsigned)(load_input_start_ms - flag_start_ms));
+        setup_start_ms = current_ms();
+        VPRINTF(2, "Finished parsing flags in %llu ms\n", (long long unsigned)(setup_start_ms - flag_start_ms));
     }
 
-    // load input image
+    // load input image and set up application on the pool, so they happen at the same time as each other and as starting the gui
+    // with `-j=1` there's no pool, and they're done one after another when waited for
     rgb24_texture_t input_image = RGB24_TEXTURE_NULL;
-    if(load_png(&input_image, argv[argc - 1])){
-        VERRPRINT(0, "Failed to load input_image");
+    thread_pool_t *pool = NULL;
+    thread_pool_batch_t *input_batch       = NULL,
+                        *application_batch = NULL;
+    int application_running = 0;
+    if(flag_config.num_threads > 1 && thread_pool_create(&pool, flag_config.num_threads - 1)){
+        VERRPRINT(0, "Failed to create pool");
+        return_code = EXIT_FAILURE;
+        goto _clean_and_exit;
+    }
+    struct load_input_task        input_task       = {argv[argc - 1], &input_image, 0, 0};
+    struct application_setup_task application_task = {&flag_config, pool, 0, 0};
+    if(thread_pool_start(pool, &application_batch, &application_setup_task, &application_task, sizeof(application_task), 1)){
+        VERRPRINT(0, "Failed to start setup");
+        return_code = EXIT_FAILURE;
+        goto _clean_and_exit;
+    }
+    // with a cache, the configuration is needed to look the result up before the input image is decoded
+    if(flag_config.cache_dir){
+        const int application_ret_code = thread_pool_wait(pool, application_batch);
+        application_batch = NULL;
+        if(application_ret_code){
+            VERRPRINT(0, "Failed to setup application");
+            return_code = EXIT_FAILURE;
+            goto _clean_and_exit;
+        }
+        application_running = 1;
+        int cache_hit;
+        if(application_fetch_cached(argv[argc - 1], &cache_hit)){
+            VERRPRINT(0, "Failed to look up the result in the cache");
+            return_code = EXIT_FAILURE;
+            goto _clean_and_exit;
+        }
+        if(cache_hit){
+            deinit_start_ms = current_ms();
+            goto _clean_and_exit;
+        }
+    }
+    if(thread_pool_start(pool, &input_batch, &load_input_task, &input_task, sizeof(input_task), 1)){
+        VERRPRINT(0, "Failed to start setup");
         return_code = EXIT_FAILURE;
         goto _clean_and_exit;
     }
 
     #if GUI_SUPPORTED
-        // get gui_start_ms
-        if(get_verbosity() >= 2){
-            gui_start_ms = current_ms();
-            VPRINTF(2, "Finished loading input image in %llu ms\n", (long long unsigned)(gui_start_ms - load_input_start_ms ));
+        // start gui, SDL has to stay on this thread
+        gui_start_ms = current_ms();
+        if(flag_config.showgui && gui_init()){
+            VERRPRINT(0, "Failed to initialize gui");
+            return_code = EXIT_FAILURE;
+            goto _clean_and_exit;
         }
+    #endif
 
-        if(!flag_config.showgui) goto _no_init_gui;
-        // initialize gui
-        if(gui_setup(input_image.width, input_image.height, 1)){
+    // wait for input image, the gui needs its size
+    const int input_ret_code = thread_pool_wait(pool, input_batch);
+    input_batch = NULL;
+    if(input_ret_code){
+        VERRPRINT(0, "Failed to load input_image");
+        return_code = EXIT_FAILURE;
+        goto _clean_and_exit;
+    }
+
+    #if GUI_SUPPORTED
+        if(flag_config.showgui && gui_setup(input_image.width, input_image.height, 1)){
             VERRPRINT(0, "Failed to initialize gui");
             return_code = EXIT_FAILURE;
             goto _clean_and_exit;
         }
-        _no_init_gui:;
+        gui_end_ms = current_ms();
     #endif
 
+    // wait for application, unless the cache already did
+    if(application_batch){
+        const int application_ret_code = thread_pool_wait(pool, application_batch);
+        application_batch = NULL;
+        if(application_ret_code){
+            VERRPRINT(0, "Failed to setup application");
+            return_code = EXIT_FAILURE;
+            goto _clean_and_exit;
+        }
+        application_running = 1;
+    }
+
     // get application_start_ms
     if(get_verbosity() >= 2){
         application_start_ms = current_ms();
+        VPRINTF(2, "Finished setup in %llu ms, of which (at the same time)\n", (long long unsigned)(application_start_ms - setup_start_ms));
+        VPRINTF(2, " loading the input image took     %llu ms (%llu to %llu)\n", (long long unsigned)(input_task.end_ms - input_task.start_ms),
+                (long long unsigned)(input_task.start_ms - setup_start_ms), (long long unsigned)(input_task.end_ms - setup_start_ms));
+        VPRINTF(2, " loading the configuration took   %llu ms (%llu to %llu)\n", (long long unsigned)(application_task.end_ms - application_task.start_ms),
+                (long long unsigned)(application_task.start_ms - setup_start_ms), (long long unsigned)(application_task.end_ms - setup_start_ms));
         #if GUI_SUPPORTED
-            VPRINTF(2, "Finished starting GUI in %llu ms\n", (long long unsigned)(application_start_ms - gui_start_ms));
-        #else
-            VPRINTF(2, "Finished loading input image in %llu ms\n", (long long unsigned)(application_start_ms - load_input_start_ms));
+            if(flag_config.showgui){
+                VPRINTF(2, " starting the GUI took            %llu ms (%llu to %llu)\n", (long long unsigned)(gui_end_ms - gui_start_ms),
+                        (long long unsigned)(gui_start_ms - setup_start_ms), (long long unsigned)(gui_end_ms - setup_start_ms));
+            }
         #endif
     }
 
     // do the thing
-    if(application_setup(&tilize_config, &flag_config)){
-        VERRPRINT(0, "Failed to setup application");
-        return_code = EXIT_FAILURE;
-        goto _clean_and_exit;
-    }
     #if GUI_SUPPORTED
         if(flag_config.showgui){
-            printf("Tilizing, press Q or Escape to cancel\n");
+            fprintf(get_print_stream(), "Tilizing, press Q or Escape to cancel\n");
         }
     #endif
-    if(application_process(&input_image)){
-        VERRPRINT(0, "Failed to process input_image");
+    const int process_ret_code = application_process(&input_image);
+    if(process_ret_code){
+        if(process_ret_code == 1) VERRPRINT(0, "Failed to process input_image");
         return_code = EXIT_FAILURE;
         goto _clean_and_exit;
     }
     application_free();
+    application_running = 0;
 
     // get deinit_start_ms
     if(get_verbosity() >= 2){
@@ -349,7 +633,7 @@ int main(int argc, const char **argv){
     #if GUI_SUPPORTED
         // wait to exit
         if(flag_config.showgui){
-            printf("Finished Tilizing, press Q or Escape to exit\n");
+            fprintf(get_print_stream(), "Finished Tilizing, press Q or Escape to exit\n");
             int waiting = 1;
             SDL_Event e;
             SDL_PumpEvents();
@@ -373,10 +657,15 @@ int main(int argc, const char **argv){
 
     // clean and exit
     _clean_and_exit:;
+    if(input_batch) thread_pool_wait(pool, input_batch);
+    if(application_batch && !thread_pool_wait(pool, application_batch)) application_running = 1;
+    if(application_running) application_free();
+    thread_pool_destroy(pool);
     #if GUI_SUPPORTED
         if(flag_config.showgui) gui_free();
     #endif
     rgb24_texture_destroy(&input_image);
+    if(flag_config.config_path) free(flag_config.config_path);
     if(return_code == EXIT_SUCCESS && get_verbosity() >= 2){
         tilize_end_ms = current_ms();
         VPRINTF(2, "Finished deinitialization in %llu ms\n", (long long unsigned)(tilize_end_ms - deinit_start_ms));
@@ -414,20 +703,52 @@ static char *strdup_exceptmyversionsobettercauseitisntc23exclusive(const char *r
     #endif
     return outp;
 }
-// gets current time in ms
-static ms_t current_ms(void){
-    #if defined(_WIN32)
-        return GetTickCount();
-    #elif defined(__unix__)
-        struct timespec ts;
-        if(!timespec_get(&ts, TIME_UTC)){
-            VERRPRINT(0, "Failed to get current time");
-            VPRINT(1, "Please ignore any timing information given after this\n");
-            return 0;
-        }
-        return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
-    #else
-        fprintf(stderr, "Warning: current_ms() not supported at compiletime\n");
-        return 0;
-    #endif
+// gets the amount of threads requested with `-j`, returns 1 if it's invalid
+static int thread_count_option(int argc, const char **argv, int *restrict num_threads){
+    int option_index;
+    if(option_provided(argc, argv, "-j", &option_index)){
+        // option provided
+        if(strlen(argv[option_index]) > 2 && argv[option_index][2] == '='){
+            // -j= option, specified thread count
+            *num_threads = atoi(&argv[option_index][3]);
+            if(*num_threads <= 0){
+                VPRINT(1, "Cannot run with non positive amount of threads. Please use a positive number for `-j`\n");
+                return 1;
+            }
+        }
+        else{
+            // -j option, get thread count
+            #if GET_THREADS_SUPPORTED
+                *num_threads = get_thread_count();
+                if(*num_threads < 0){
+                    VERRPRINT(0, "Failed to get thread count");
+                    return 1;
+                }
+            #else
+                VPRINT(1, "Your system does not currently support the `-j` option. Please use `-j=` instead.\n");
+                return 1;
+            #endif
+        }
+    }
+    else{
+        // option not provided
+        *num_threads = 1;
+    }
+    return 0;
+}
+// loads the input image of a struct load_input_task
+static int load_input_task(void *task_void){
+    struct load_input_task *task = task_void;
+    task->start_ms = current_ms();
+    const int ret_code = load_png(task->image, task->path);
+    task->end_ms = current_ms();
+    return ret_code;
+}
+// sets up the application for a struct application_setup_task
+static int application_setup_task(void *task_void){
+    struct application_setup_task *task = task_void;
+    task->start_ms = current_ms();
+    const int ret_code = application_setup(task->flag_config, task->pool);
+    task->end_ms = current_ms();
+    return ret_code;
 }
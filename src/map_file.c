@@ -0,0 +1,183 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define _POSIX_C_SOURCE 200809L
+#endif
+#include "map_file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "print.h"
+#if MAP_FILE_SUPPORTED
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// reads all of stream into file
+static int read_stream(mapped_file_t *restrict file, FILE *stream, const char *restrict path);
+
+// maps the file at path into file
+// a path of "-" reads all of stdin instead, which can't be mapped
+int map_file(mapped_file_t *restrict file, const char *restrict path){
+    *file = MAPPED_FILE_NULL;
+    if(!strcmp(path, "-")) return read_stream(file, stdin, path);
+    #if MAP_FILE_SUPPORTED
+        int fd = open(path, O_RDONLY);
+        if(fd < 0){
+            VERRPRINTF(0, "Failed to open %s", path);
+            return 1;
+        }
+        struct stat file_stat;
+        if(fstat(fd, &file_stat)){
+            VERRPRINTF(0, "Failed to stat %s", path);
+            close(fd);
+            return 1;
+        }
+        if(file_stat.st_size == 0){
+            // mmap() doesn't like empty files, so those just stay NULL
+            close(fd);
+            return 0;
+        }
+        void *data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if(data == MAP_FAILED){
+            VERRPRINTF(0, "Failed to map %s", path);
+            return 1;
+        }
+        file->data = data;
+        file->size = file_stat.st_size;
+        return 0;
+    #else
+        FILE *f = fopen(path, "rb");
+        if(!f){
+            VERRPRINTF(0, "Failed to open %s", path);
+            return 1;
+        }
+        if(fseek(f, 0, SEEK_END)){
+            VERRPRINTF(0, "Failed to seek to end of %s", path);
+            fclose(f);
+            return 1;
+        }
+        long size = ftell(f);
+        if(size == -1L){
+            VERRPRINTF(0, "Failed to tell position in %s", path);
+            fclose(f);
+            return 1;
+        }
+        rewind(f);
+        if(size == 0){
+            fclose(f);
+            return 0;
+        }
+        unsigned char *data = malloc(size);
+        if(!data){
+            VERRPRINT(0, "Failed to allocate data");
+            fclose(f);
+            return 1;
+        }
+        if(fread(data, 1, size, f) != (size_t)size){
+            VERRPRINTF(0, "Failed to read %s", path);
+            free(data);
+            fclose(f);
+            return 1;
+        }
+        fclose(f);
+        file->data      = data;
+        file->size      = size;
+        file->allocated = 1;
+        return 0;
+    #endif
+}
+// reads the file at path into allocated memory in file instead of mapping it
+// for files that might be changed while they're used, which with a mapping could crash
+int read_file(mapped_file_t *restrict file, const char *restrict path){
+    *file = MAPPED_FILE_NULL;
+    if(!strcmp(path, "-")) return read_stream(file, stdin, path);
+    FILE *f = fopen(path, "rb");
+    if(!f){
+        VERRPRINTF(0, "Failed to open %s", path);
+        return 1;
+    }
+    const int ret_code = read_stream(file, f, path);
+    fclose(f);
+    return ret_code;
+}
+// unmaps file
+void unmap_file(mapped_file_t *file){
+    if(file->data){
+        if(file->allocated) free((void *)file->data);
+        #if MAP_FILE_SUPPORTED
+            else munmap((void *)file->data, file->size);
+        #endif
+    }
+    *file = MAPPED_FILE_NULL;
+}
+
+// reads all of stream into file
+static int read_stream(mapped_file_t *restrict file, FILE *stream, const char *restrict path){
+    unsigned char *data     = NULL;
+    size_t         size     = 0,
+                   capacity = 0;
+    while(1){
+        if(size == capacity){
+            capacity = capacity ? capacity * 2 : 1 << 16;
+            unsigned char *new_data = realloc(data, capacity);
+            if(!new_data){
+                VERRPRINT(0, "Failed to reallocate data");
+                free(data);
+                return 1;
+            }
+            data = new_data;
+        }
+        const size_t read = fread(data + size, 1, capacity - size, stream);
+        size += read;
+        if(read == 0) break;
+    }
+    if(ferror(stream)){
+        VERRPRINTF(0, "Failed to read %s", path);
+        free(data);
+        return 1;
+    }
+    if(size == 0){
+        free(data);
+        return 0;
+    }
+    file->data      = data;
+    file->size      = size;
+    file->allocated = 1;
+    return 0;
+}
@@ -0,0 +1,65 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#ifndef MAP_FILE_H__
+#define MAP_FILE_H__
+
+#include <stddef.h>
+
+#ifndef MAP_FILE_SUPPORTED
+    #if defined(__unix__) || defined(__APPLE__)
+        #define MAP_FILE_SUPPORTED 1
+    #else
+        #define MAP_FILE_SUPPORTED 0
+    #endif
+#endif
+
+// the read only contents of a file, mapped into memory if MAP_FILE_SUPPORTED, otherwise read into it
+typedef struct mapped_file_t{
+    const unsigned char *data;
+    size_t               size;
+    int                  allocated; // whether data was read into allocated memory instead of being mapped
+} mapped_file_t;
+
+#define MAPPED_FILE_NULL ((mapped_file_t){NULL, 0, 0})
+
+// maps the file at path into file
+// a path of "-" reads all of stdin instead, which can't be mapped
+int map_file(mapped_file_t *restrict file, const char *restrict path);
+// reads the file at path into allocated memory in file instead of mapping it
+// for files that might be changed while they're used, which with a mapping could crash
+int read_file(mapped_file_t *restrict file, const char *restrict path);
+// unmaps file
+void unmap_file(mapped_file_t *file);
+
+#endif
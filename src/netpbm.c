@@ -0,0 +1,214 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#include "netpbm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "map_file.h"
+#include "print.h"
+
+// largest image accepted, in pixels
+#define MAX_PIXELS (1L << 28)
+
+// the header of a ppm or pam file
+struct netpbm_header{
+    long   width,
+           height,
+           depth,  // samples per pixel
+           maxval; // largest value of a sample
+    size_t size;   // in bytes, the pixels follow right after
+};
+
+// reads the next number of the ppm header in data (skipping whitespace and comments) from *position on into value
+static int read_ppm_number(const unsigned char *data, size_t size, size_t *position, long *value);
+// reads the header of the ppm file in data into header
+static int read_ppm_header(const unsigned char *data, size_t size, struct netpbm_header *header);
+// reads the header of the pam file in data into header
+static int read_pam_header(const unsigned char *data, size_t size, struct netpbm_header *header);
+// writes header, followed by the pixels of texture, to path
+static int save_netpbm(const char *path, const char *header, const rgb24_texture_t *restrict texture);
+
+// loads texture from the binary ppm (P6) or pam (P7) file at path
+// with 8 bit rgb pixels (as written by save_ppm() and save_pam()), the file is mapped and texture points right into it
+int load_netpbm(rgb24_texture_t *restrict texture, const char *path){
+    mapped_file_t file = MAPPED_FILE_NULL;
+    if(map_file(&file, path)){
+        VERRPRINTF(0, "Failed to map %s", path);
+        return 1;
+    }
+    return decode_netpbm(texture, &file, path);
+}
+// decodes the binary ppm (P6) or pam (P7) file in file into texture, file is unmapped unless texture points into it, name is only used for messages
+int decode_netpbm(rgb24_texture_t *restrict texture, mapped_file_t *file, const char *name){
+    struct netpbm_header header;
+    if(file->size < 2 || file->data[0] != 'P' || (file->data[1] == '6' ? read_ppm_header(file->data, file->size, &header) :
+                                                file->data[1] == '7' ? read_pam_header(file->data, file->size, &header) : 1)){
+        VERRPRINTF(0, "%s is not a binary ppm or pam file", name);
+        unmap_file(file);
+        return 1;
+    }
+    const int    bytes_per_sample = header.maxval > 255 ? 2 : 1;
+    const size_t num_pixels       = (size_t)header.width * header.height;
+    if(header.width < 1 || header.height < 1 || header.width > INT_MAX || header.height > INT_MAX || num_pixels > MAX_PIXELS ||
+       header.depth < 1 || header.depth > 4 || header.maxval < 1 || header.maxval > 65535 ||
+       file->size - header.size < num_pixels * header.depth * bytes_per_sample){
+        VERRPRINTF(0, "%s is too large, damaged or has a kind of pixels that isn't supported", name);
+        unmap_file(file);
+        return 1;
+    }
+
+    // 8 bit rgb, use the pixels where they are
+    if(header.depth == 3 && header.maxval == 255 && sizeof(rgb24_t) == 3){
+        texture->width   = header.width;
+        texture->height  = header.height;
+        texture->data    = (rgb24_t *)(file->data + header.size);
+        texture->mapping = *file;
+        return 0;
+    }
+
+    // anything else, convert (grayscale is spread to all channels, alpha is dropped)
+    if(rgb24_texture_create(texture, header.width, header.height)){
+        VERRPRINT(0, "Failed to create texture");
+        unmap_file(file);
+        return 1;
+    }
+    const unsigned char *pixels = file->data + header.size;
+    for(size_t i = 0; i < num_pixels; ++i){
+        unsigned char channels[3];
+        for(int c = 0; c < 3; ++c){
+            const size_t sample = (i * header.depth + (header.depth >= 3 ? c : 0)) * bytes_per_sample;
+            const long   value  = bytes_per_sample == 2 ? pixels[sample] << 8 | pixels[sample + 1] : pixels[sample];
+            channels[c] = (value > header.maxval ? header.maxval : value) * 255 / header.maxval;
+        }
+        texture->data[i] = RGB24(channels[0], channels[1], channels[2]);
+    }
+    unmap_file(file);
+    return 0;
+}
+// saves texture to path as a binary ppm (P6)
+int save_ppm(const char *path, const rgb24_texture_t *restrict texture){
+    char header[64];
+    snprintf(header, sizeof(header), "P6\n%i %i\n255\n", texture->width, texture->height);
+    return save_netpbm(path, header, texture);
+}
+// saves texture to path as a pam (P7) with the tuple type RGB
+int save_pam(const char *path, const rgb24_texture_t *restrict texture){
+    char header[128];
+    snprintf(header, sizeof(header), "P7\nWIDTH %i\nHEIGHT %i\nDEPTH 3\nMAXVAL 255\nTUPLTYPE RGB\nENDHDR\n", texture->width, texture->height);
+    return save_netpbm(path, header, texture);
+}
+
+// reads the next number of the ppm header in data (skipping whitespace and comments) from *position on into value
+static int read_ppm_number(const unsigned char *data, size_t size, size_t *position, long *value){
+    size_t i = *position;
+    while(i < size){
+        if(data[i] == '#') while(i < size && data[i] != '\n') ++i;
+        else if(data[i] == ' ' || data[i] == '\t' || data[i] == '\n' || data[i] == '\r') ++i;
+        else break;
+    }
+    if(i >= size || data[i] < '0' || data[i] > '9') return 1;
+    *value = 0;
+    while(i < size && data[i] >= '0' && data[i] <= '9'){
+        if(*value > INT_MAX / 10) return 1;
+        *value = *value * 10 + (data[i++] - '0');
+    }
+    *position = i;
+    return 0;
+}
+// reads the header of the ppm file in data into header
+static int read_ppm_header(const unsigned char *data, size_t size, struct netpbm_header *header){
+    size_t position = 2;
+    if(read_ppm_number(data, size, &position, &header->width) ||
+       read_ppm_number(data, size, &position, &header->height) ||
+       read_ppm_number(data, size, &position, &header->maxval) ||
+       position >= size){
+        return 1;
+    }
+    header->depth = 3;
+    header->size  = position + 1; // exactly one whitespace character before the pixels
+    return 0;
+}
+// reads the header of the pam file in data into header
+static int read_pam_header(const unsigned char *data, size_t size, struct netpbm_header *header){
+    header->width = header->height = header->depth = header->maxval = -1;
+    size_t position = 2;
+    while(position < size){
+        // one `KEY value` per line
+        size_t line_end = position;
+        while(line_end < size && data[line_end] != '\n') ++line_end;
+        if(line_end >= size) return 1;
+        const char  *line        = (const char *)data + position;
+        const size_t line_length = line_end - position;
+        if(line_length >= 6 && !memcmp(line, "ENDHDR", 6)){
+            header->size = line_end + 1;
+            return header->width < 0 || header->height < 0 || header->depth < 0 || header->maxval < 0;
+        }
+        static const char *const keys[] = {"WIDTH", "HEIGHT", "DEPTH", "MAXVAL"};
+        long *const values[] = {&header->width, &header->height, &header->depth, &header->maxval};
+        for(int k = 0; k < 4; ++k){
+            const size_t key_length = strlen(keys[k]);
+            if(line_length <= key_length || memcmp(line, keys[k], key_length) || (line[key_length] != ' ' && line[key_length] != '\t')) continue;
+            size_t value_position = position + key_length;
+            if(read_ppm_number(data, line_end, &value_position, values[k])) return 1;
+        }
+        // anything else (TUPLTYPE, comments, the rest of the `P7` line) doesn't matter, depth says what the pixels are
+        position = line_end + 1;
+    }
+    return 1;
+}
+// writes header, followed by the pixels of texture, to path
+static int save_netpbm(const char *path, const char *header, const rgb24_texture_t *restrict texture){
+    FILE *file = strcmp(path, "-") ? fopen(path, "wb") : stdout; // "-" is stdout
+    if(!file){
+        VERRPRINTF(0, "Failed to open %s", path);
+        return 1;
+    }
+    int          ret_code   = 0;
+    const size_t num_pixels = (size_t)texture->width * texture->height;
+    if(fputs(header, file) == EOF) ret_code = 1;
+    else if(sizeof(rgb24_t) == 3){
+        if(fwrite(texture->data, 3, num_pixels, file) != num_pixels) ret_code = 1;
+    }
+    else{
+        for(size_t i = 0; !ret_code && i < num_pixels; ++i){
+            const unsigned char pixel[3] = {texture->data[i].r, texture->data[i].g, texture->data[i].b};
+            if(fwrite(pixel, 3, 1, file) != 1) ret_code = 1;
+        }
+    }
+    if(file == stdout ? fflush(file) : fclose(file)) ret_code = 1;
+    if(ret_code) VERRPRINTF(0, "Failed to write %s", path);
+    return ret_code;
+}
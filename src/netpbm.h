@@ -0,0 +1,49 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#ifndef NETPBM_H__
+#define NETPBM_H__
+
+#include "texture.h"
+
+// loads texture from the binary ppm (P6) or pam (P7) file at path
+// with 8 bit rgb pixels (as written by save_ppm() and save_pam()), the file is mapped and texture points right into it
+int load_netpbm(rgb24_texture_t *restrict texture, const char *path);
+// decodes the binary ppm (P6) or pam (P7) file in file into texture, file is unmapped unless texture points into it, name is only used for messages
+int decode_netpbm(rgb24_texture_t *restrict texture, mapped_file_t *file, const char *name);
+// saves texture to path as a binary ppm (P6)
+int save_ppm(const char *path, const rgb24_texture_t *restrict texture);
+// saves texture to path as a pam (P7) with the tuple type RGB
+int save_pam(const char *path, const rgb24_texture_t *restrict texture);
+
+#endif
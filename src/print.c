@@ -39,6 +39,8 @@
 
 // current verbosity
 static int verbosity = DEFAULT_VERBOSITY;
+// stream VPRINT() and VPRINTF() print to, stdout if NULL
+static FILE *print_stream = NULL;
 
 // gets current verbosity
 int get_verbosity(void){
@@ -48,3 +50,12 @@ int get_verbosity(void){
 void set_verbosity(int v){
     verbosity = v;
 }
+
+// gets the stream VPRINT() and VPRINTF() print to
+FILE *get_print_stream(void){
+    return print_stream ? print_stream : stdout;
+}
+// sets the stream VPRINT() and VPRINTF() print to, for example stderr when stdout is used for something else
+void set_print_stream(FILE *stream){
+    print_stream = stream;
+}
@@ -36,9 +36,9 @@
 
 #include <stdio.h>
 
-// print to stdout if verbosity is at least min_verb
-#define VPRINT(min_verb, str)       if(get_verbosity() >= min_verb) printf(str)
-#define VPRINTF(min_verb, str, ...) if(get_verbosity() >= min_verb) printf(str, __VA_ARGS__)
+// print to stdout (or whatever set_print_stream() was given) if verbosity is at least min_verb
+#define VPRINT(min_verb, str)       if(get_verbosity() >= min_verb) fprintf(get_print_stream(), str)
+#define VPRINTF(min_verb, str, ...) if(get_verbosity() >= min_verb) fprintf(get_print_stream(), str, __VA_ARGS__)
 
 // print to stderr with line, function and file information if verbosity is at least min_verb and if NDEBUG is undefined or zero
 #if NDEBUG
@@ -54,4 +54,9 @@ int get_verbosity(void);
 // sets verbosity
 void set_verbosity(int v);
 
+// gets the stream VPRINT() and VPRINTF() print to
+FILE *get_print_stream(void);
+// sets the stream VPRINT() and VPRINTF() print to, for example stderr when stdout is used for something else
+void set_print_stream(FILE *stream);
+
 #endif
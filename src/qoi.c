@@ -0,0 +1,227 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#include "qoi.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "map_file.h"
+#include "print.h"
+
+// largest image accepted, in pixels
+#define MAX_PIXELS (1L << 28)
+
+#define QOI_HEADER_SIZE 14
+#define QOI_PADDING     8  // 7 zeros and a one end every file
+#define QOI_OP_INDEX    0x00
+#define QOI_OP_DIFF     0x40
+#define QOI_OP_LUMA     0x80
+#define QOI_OP_RUN      0xc0
+#define QOI_OP_RGB      0xfe
+#define QOI_OP_RGBA     0xff
+#define QOI_MASK_2      0xc0
+
+// a pixel while en- or decoding
+struct qoi_pixel{
+    uint8_t r, g, b, a;
+};
+
+// index of px in the array of recently seen pixels
+#define QOI_HASH(px) (((px).r * 3 + (px).g * 5 + (px).b * 7 + (px).a * 11) % 64)
+
+// loads texture from the qoi file (https://qoiformat.org) at path, alpha is dropped
+int load_qoi(rgb24_texture_t *restrict texture, const char *path){
+    mapped_file_t file = MAPPED_FILE_NULL;
+    if(map_file(&file, path)){
+        VERRPRINTF(0, "Failed to map %s", path);
+        return 1;
+    }
+    return decode_qoi(texture, &file, path);
+}
+// decodes the qoi file in file into texture and unmaps file, name is only used for messages
+int decode_qoi(rgb24_texture_t *restrict texture, mapped_file_t *file, const char *name){
+    const unsigned char *data = file->data;
+    if(file->size < QOI_HEADER_SIZE + QOI_PADDING || memcmp(data, "qoif", 4)){
+        VERRPRINTF(0, "%s is not a qoi file", name);
+        unmap_file(file);
+        return 1;
+    }
+    const uint32_t width  = (uint32_t)data[4] << 24 | (uint32_t)data[5] << 16 | (uint32_t)data[6] << 8 | data[7],
+                   height = (uint32_t)data[8] << 24 | (uint32_t)data[9] << 16 | (uint32_t)data[10] << 8 | data[11];
+    if(width < 1 || height < 1 || (uint64_t)width * height > MAX_PIXELS){
+        VERRPRINTF(0, "%s is too large or empty", name);
+        unmap_file(file);
+        return 1;
+    }
+    if(rgb24_texture_create(texture, width, height)){
+        VERRPRINT(0, "Failed to create texture");
+        unmap_file(file);
+        return 1;
+    }
+
+    struct qoi_pixel index[64],
+                     px    = {0, 0, 0, 255};
+    memset(index, 0, sizeof(index));
+    const size_t num_pixels = (size_t)width * height,
+                 chunks_end = file->size - QOI_PADDING;
+    size_t       position   = QOI_HEADER_SIZE;
+    int          run        = 0;
+    size_t       i;
+    for(i = 0; i < num_pixels; ++i){
+        if(run > 0) --run;
+        else if(position < chunks_end){
+            const int b1 = data[position++];
+            if(b1 == QOI_OP_RGB){
+                if(position + 3 > chunks_end) break;
+                px.r = data[position++];
+                px.g = data[position++];
+                px.b = data[position++];
+            }
+            else if(b1 == QOI_OP_RGBA){
+                if(position + 4 > chunks_end) break;
+                px.r = data[position++];
+                px.g = data[position++];
+                px.b = data[position++];
+                px.a = data[position++];
+            }
+            else if((b1 & QOI_MASK_2) == QOI_OP_INDEX) px = index[b1];
+            else if((b1 & QOI_MASK_2) == QOI_OP_DIFF){
+                px.r += ((b1 >> 4) & 0x03) - 2;
+                px.g += ((b1 >> 2) & 0x03) - 2;
+                px.b += ( b1       & 0x03) - 2;
+            }
+            else if((b1 & QOI_MASK_2) == QOI_OP_LUMA){
+                if(position + 1 > chunks_end) break;
+                const int b2 = data[position++],
+                          vg = (b1 & 0x3f) - 32;
+                px.r += vg - 8 + ((b2 >> 4) & 0x0f);
+                px.g += vg;
+                px.b += vg - 8 +  (b2       & 0x0f);
+            }
+            else run = b1 & 0x3f;
+            index[QOI_HASH(px)] = px;
+        }
+        texture->data[i] = RGB24(px.r, px.g, px.b);
+    }
+    unmap_file(file);
+    if(i < num_pixels){
+        VERRPRINTF(0, "%s is damaged", name);
+        rgb24_texture_destroy(texture);
+        return 1;
+    }
+    return 0;
+}
+// saves texture to path as a qoi file with 3 channels
+int save_qoi(const char *path, const rgb24_texture_t *restrict texture){
+    // every pixel takes at most 4 bytes with 3 channels
+    const size_t   num_pixels = (size_t)texture->width * texture->height;
+    unsigned char *bytes      = malloc(QOI_HEADER_SIZE + num_pixels * 4 + QOI_PADDING);
+    if(!bytes){
+        VERRPRINT(0, "Failed to allocate bytes");
+        return 1;
+    }
+    size_t size = 0;
+    memcpy(bytes, "qoif", 4);
+    size += 4;
+    const uint32_t dimensions[2] = {texture->width, texture->height};
+    for(int d = 0; d < 2; ++d){
+        bytes[size++] = dimensions[d] >> 24;
+        bytes[size++] = dimensions[d] >> 16;
+        bytes[size++] = dimensions[d] >> 8;
+        bytes[size++] = dimensions[d];
+    }
+    bytes[size++] = 3; // channels
+    bytes[size++] = 0; // sRGB with linear alpha
+
+    struct qoi_pixel index[64],
+                     prev  = {0, 0, 0, 255};
+    memset(index, 0, sizeof(index));
+    int run = 0;
+    for(size_t i = 0; i < num_pixels; ++i){
+        const struct qoi_pixel px = {texture->data[i].r, texture->data[i].g, texture->data[i].b, 255};
+        if(!memcmp(&px, &prev, sizeof(px))){
+            ++run;
+            if(run == 62 || i == num_pixels - 1){
+                bytes[size++] = QOI_OP_RUN | (run - 1);
+                run = 0;
+            }
+            continue;
+        }
+        if(run > 0){
+            bytes[size++] = QOI_OP_RUN | (run - 1);
+            run = 0;
+        }
+        const int hash = QOI_HASH(px);
+        if(!memcmp(&index[hash], &px, sizeof(px))) bytes[size++] = QOI_OP_INDEX | hash;
+        else{
+            index[hash] = px;
+            const int8_t vr   = px.r - prev.r,
+                         vg   = px.g - prev.g,
+                         vb   = px.b - prev.b,
+                         vg_r = vr - vg,
+                         vg_b = vb - vg;
+            if(vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2){
+                bytes[size++] = QOI_OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2);
+            }
+            else if(vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 && vg_b > -9 && vg_b < 8){
+                bytes[size++] = QOI_OP_LUMA | (vg + 32);
+                bytes[size++] = (vg_r + 8) << 4 | (vg_b + 8);
+            }
+            else{
+                bytes[size++] = QOI_OP_RGB;
+                bytes[size++] = px.r;
+                bytes[size++] = px.g;
+                bytes[size++] = px.b;
+            }
+        }
+        prev = px;
+    }
+    memset(bytes + size, 0, QOI_PADDING - 1);
+    size += QOI_PADDING - 1;
+    bytes[size++] = 1;
+
+    FILE *file = strcmp(path, "-") ? fopen(path, "wb") : stdout; // "-" is stdout
+    if(!file){
+        VERRPRINTF(0, "Failed to open %s", path);
+        free(bytes);
+        return 1;
+    }
+    int ret_code = 0;
+    if(fwrite(bytes, 1, size, file) != size) ret_code = 1;
+    if(file == stdout ? fflush(file) : fclose(file)) ret_code = 1;
+    if(ret_code) VERRPRINTF(0, "Failed to write %s", path);
+    free(bytes);
+    return ret_code;
+}
@@ -0,0 +1,203 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#include "region.h"
+
+#include <stdlib.h>
+#include <limits.h>
+#include "load_png.h"
+#include "print.h"
+
+// returns whether tile tile_x, tile_y of tile_map overlaps rect
+static int tile_in_rect(const tilize_tile_map_t *tile_map, int tile_x, int tile_y, tilize_rect_t rect);
+// returns whether a pixel of tile tile_x, tile_y of tile_map has a red value of at least 128 in mask
+static int tile_in_mask(const tilize_tile_map_t *tile_map, int tile_x, int tile_y, const rgb24_texture_t *mask);
+
+// parses rectangles written as `x,y,width,height`, separated by `:`, into rects (freed by the caller) and num_rects
+int region_parse_rects(const char *str, tilize_rect_t **rects, int *num_rects){
+    int count = 1;
+    for(const char *c = str; *c; ++c) count += *c == ':';
+    *rects = malloc(count * sizeof(**rects));
+    if(!*rects){
+        VERRPRINT(0, "Failed to allocate rects");
+        return 1;
+    }
+    for(int i = 0; i < count; ++i){
+        long  values[4];
+        char *end = (char *)str;
+        for(int j = 0; j < 4; ++j){
+            values[j] = strtol(str, &end, 10);
+            if(end == str || *end != (j < 3 ? ',' : (i < count - 1 ? ':' : 0)) || values[j] < 0 || values[j] > INT_MAX){
+                VERRPRINTF(0, "Failed to parse rectangle %i, it should look like `x,y,width,height`", i + 1);
+                free(*rects);
+                *rects = NULL;
+                return 1;
+            }
+            str = end + 1;
+        }
+        (*rects)[i] = (tilize_rect_t){values[0], values[1], values[2], values[3]};
+    }
+    *num_rects = count;
+    return 0;
+}
+
+// sets up tile_map, made for input_texture with context, so only the tiles that changed since the result at previous_path was made are searched
+// previous_path is either a tile map, whose tiles are kept, or an image, which gets loaded into previous_texture and whose tiles are marked TILIZE_TILE_SKIP
+// (to be copied into the result with tilize_tile_map_copy_skipped())
+// changes are found by comparing input_texture to the image at old_input_path if it isn't NULL, and are the rectangles in dirty_rects if that isn't NULL
+int region_from_previous(tilize_tile_map_t *tile_map, rgb24_texture_t *previous_texture, const tilize_context_t *context, const rgb24_texture_t *input_texture,
+                         const char *previous_path, const char *old_input_path, const char *dirty_rects){
+    int               ret_code      = 1;
+    tilize_tile_map_t previous_map  = TILIZE_TILE_MAP_NULL;
+    rgb24_texture_t   old_input     = RGB24_TEXTURE_NULL;
+    tilize_rect_t    *rects         = NULL;
+    int               num_rects     = 0;
+
+    // keep everything of the previous result
+    if(tilize_tile_map_is_file(previous_path)){
+        if(tilize_tile_map_load(&previous_map, previous_path)){
+            VERRPRINTF(0, "Failed to load %s", previous_path);
+            goto _clean_and_exit;
+        }
+        if(previous_map.image_width != input_texture->width || previous_map.image_height != input_texture->height ||
+           previous_map.tile_width != tile_map->tile_width || previous_map.tile_height != tile_map->tile_height ||
+           previous_map.tile_amount_x != tile_map->tile_amount_x || previous_map.tile_amount_y != tile_map->tile_amount_y ||
+           previous_map.config_hash != tilize_context_hash(context)){
+            VPRINTF(1, "%s was made for an image of a different size or with a different configuration\n", previous_path);
+            goto _clean_and_exit;
+        }
+        for(int i = 0; i < tile_map->tile_amount_x * tile_map->tile_amount_y; ++i){
+            if(previous_map.tiles[i].pattern >= 0) tile_map->tiles[i] = previous_map.tiles[i];
+        }
+    }
+    else{
+        if(load_png(previous_texture, previous_path)){
+            VERRPRINTF(0, "Failed to load %s", previous_path);
+            goto _clean_and_exit;
+        }
+        if(previous_texture->width != input_texture->width || previous_texture->height != input_texture->height){
+            VPRINTF(1, "%s isn't the size of the input\n", previous_path);
+            goto _clean_and_exit;
+        }
+        for(int i = 0; i < tile_map->tile_amount_x * tile_map->tile_amount_y; ++i) tile_map->tiles[i].pattern = TILIZE_TILE_SKIP;
+    }
+
+    // except for what changed
+    if(old_input_path){
+        if(load_png(&old_input, old_input_path)){
+            VERRPRINTF(0, "Failed to load %s", old_input_path);
+            goto _clean_and_exit;
+        }
+        if(old_input.width != input_texture->width || old_input.height != input_texture->height){
+            VPRINTF(1, "%s isn't the size of the input\n", old_input_path);
+            goto _clean_and_exit;
+        }
+        tilize_tile_map_mark_changed(tile_map, &old_input, input_texture, TILIZE_TILE_TODO);
+    }
+    if(dirty_rects){
+        if(region_parse_rects(dirty_rects, &rects, &num_rects)) goto _clean_and_exit;
+        for(int i = 0; i < num_rects; ++i) tilize_tile_map_mark_rect(tile_map, rects[i], TILIZE_TILE_TODO);
+    }
+
+    int num_todo = 0;
+    for(int i = 0; i < tile_map->tile_amount_x * tile_map->tile_amount_y; ++i) num_todo += tile_map->tiles[i].pattern == TILIZE_TILE_TODO;
+    VPRINTF(2, "%i of %i tiles changed since %s\n", num_todo, tile_map->tile_amount_x * tile_map->tile_amount_y, previous_path);
+    ret_code = 0;
+
+_clean_and_exit:
+    free(rects);
+    rgb24_texture_destroy(&old_input);
+    tilize_tile_map_destroy(&previous_map);
+    return ret_code;
+}
+// marks every TILIZE_TILE_TODO tile of tile_map as TILIZE_TILE_SKIP unless it overlaps one of the rectangles in roi (if not NULL)
+// and a pixel of the image at mask_path (if not NULL, the size of the image tile_map was made for) with a red value of at least 128
+int region_restrict(tilize_tile_map_t *tile_map, const char *roi, const char *mask_path){
+    int              ret_code  = 1;
+    tilize_rect_t   *rects     = NULL;
+    int              num_rects = 0;
+    rgb24_texture_t  mask      = RGB24_TEXTURE_NULL;
+    if(roi && region_parse_rects(roi, &rects, &num_rects)) goto _clean_and_exit;
+    if(mask_path){
+        if(load_png(&mask, mask_path)){
+            VERRPRINTF(0, "Failed to load %s", mask_path);
+            goto _clean_and_exit;
+        }
+        if(mask.width != tile_map->image_width || mask.height != tile_map->image_height){
+            VPRINTF(1, "%s isn't the size of the input\n", mask_path);
+            goto _clean_and_exit;
+        }
+    }
+
+    int num_selected = 0;
+    for(int ty = 0; ty < tile_map->tile_amount_y; ++ty){
+        for(int tx = 0; tx < tile_map->tile_amount_x; ++tx){
+            tilize_tile_t *tile = &tile_map->tiles[ty * tile_map->tile_amount_x + tx];
+            if(tile->pattern != TILIZE_TILE_TODO) continue;
+            int selected = !roi;
+            for(int i = 0; !selected && i < num_rects; ++i) selected = tile_in_rect(tile_map, tx, ty, rects[i]);
+            if(selected && mask_path) selected = tile_in_mask(tile_map, tx, ty, &mask);
+            if(selected) ++num_selected;
+            else         tile->pattern = TILIZE_TILE_SKIP;
+        }
+    }
+    VPRINTF(2, "Tilizing %i of %i tiles\n", num_selected, tile_map->tile_amount_x * tile_map->tile_amount_y);
+    ret_code = 0;
+
+_clean_and_exit:
+    free(rects);
+    rgb24_texture_destroy(&mask);
+    return ret_code;
+}
+
+// returns whether tile tile_x, tile_y of tile_map overlaps rect
+static int tile_in_rect(const tilize_tile_map_t *tile_map, int tile_x, int tile_y, tilize_rect_t rect){
+    const long long x_min = (long long)tile_x * tile_map->tile_width,
+                    y_min = (long long)tile_y * tile_map->tile_height;
+    return rect.width > 0 && rect.height > 0 &&
+           x_min < (long long)rect.x + rect.width && rect.x < x_min + tile_map->tile_width &&
+           y_min < (long long)rect.y + rect.height && rect.y < y_min + tile_map->tile_height;
+}
+// returns whether a pixel of tile tile_x, tile_y of tile_map has a red value of at least 128 in mask
+static int tile_in_mask(const tilize_tile_map_t *tile_map, int tile_x, int tile_y, const rgb24_texture_t *mask){
+    const int x_min = tile_x * tile_map->tile_width,
+              y_min = tile_y * tile_map->tile_height,
+              x_max = x_min + tile_map->tile_width < mask->width ? x_min + tile_map->tile_width : mask->width,
+              y_max = y_min + tile_map->tile_height < mask->height ? y_min + tile_map->tile_height : mask->height;
+    for(int y = y_min; y < y_max; ++y){
+        for(int x = x_min; x < x_max; ++x){
+            if(mask->data[(size_t)y * mask->width + x].r >= 0x80) return 1;
+        }
+    }
+    return 0;
+}
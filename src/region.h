@@ -0,0 +1,53 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#ifndef REGION_H__
+#define REGION_H__
+
+#include "texture.h"
+#include "tilize.h"
+
+// parses rectangles written as `x,y,width,height`, separated by `:`, into rects (freed by the caller) and num_rects
+int region_parse_rects(const char *str, tilize_rect_t **rects, int *num_rects);
+
+// sets up tile_map, made for input_texture with context, so only the tiles that changed since the result at previous_path was made are searched
+// previous_path is either a tile map, whose tiles are kept, or an image, which gets loaded into previous_texture and whose tiles are marked TILIZE_TILE_SKIP
+// (to be copied into the result with tilize_tile_map_copy_skipped())
+// changes are found by comparing input_texture to the image at old_input_path if it isn't NULL, and are the rectangles in dirty_rects if that isn't NULL
+int region_from_previous(tilize_tile_map_t *tile_map, rgb24_texture_t *previous_texture, const tilize_context_t *context, const rgb24_texture_t *input_texture,
+                         const char *previous_path, const char *old_input_path, const char *dirty_rects);
+// marks every TILIZE_TILE_TODO tile of tile_map as TILIZE_TILE_SKIP unless it overlaps one of the rectangles in roi (if not NULL)
+// and a pixel of the image at mask_path (if not NULL, the size of the image tile_map was made for) with a red value of at least 128
+int region_restrict(tilize_tile_map_t *tile_map, const char *roi, const char *mask_path);
+
+#endif
@@ -0,0 +1,942 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#include "search.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include "print.h"
+
+// patterns and columns of FG computed at once by the matrix multiplication kernel, kept in registers
+#define KERNEL_PATTERNS 4
+#define KERNEL_COLUMNS  8
+// what a column of D can be used as
+#define USE_COL1 1
+#define USE_COL2 2
+// most patterns in a leaf of the vantage point tree
+#define INDEX_LEAF_SIZE 8
+
+// a node of the vantage point tree
+struct index_node{
+    int vantage,      // pattern the hamming distances are measured from, -1 for leaves
+        first,        // leaves: patterns order[first] to order[first + count - 1]
+        count,
+        lowest,       // lowest pattern in this node and its children
+        inside,       // child nodes with patterns closer to / further from vantage, -1 if there are none
+        outside,
+        inside_min,   // smallest and largest hamming distance to vantage of the patterns in each child
+        inside_max,
+        outside_min,
+        outside_max;
+};
+// a pattern and its hamming distance to a vantage point, used while building the tree
+struct index_entry{
+    int distance,
+        pattern;
+};
+
+// finds the best pattern and colors for tiles
+struct search_t{
+    int            tile_size,        // pixels per tile
+                   num_patterns,
+                   padded_patterns,  // num_patterns rounded up to KERNEL_PATTERNS
+                   col_min,          // colors D is computed for, covering both col1 and col2 ranges
+                   num_cols,
+                   col1_min,
+                   col1_max,
+                   col2_min,
+                   col2_max,
+                   block_columns;    // columns of D scored at once, a multiple of KERNEL_COLUMNS
+    // multiply or its variant for tile_size
+    void         (*multiply)(const search_t *restrict search, search_scratch_t *restrict scratch, int columns);
+    unsigned char *masks;            // padded_patterns masks of 0s and 1s, padding ones are all 0
+    rgb24_t       *colors;           // num_cols colors, starting at col_min
+    int           *pattern_index;    // index each pattern had in the masks search was created with
+    // vantage point tree, only if num_patterns >= SEARCH_INDEX_MIN_PATTERNS
+    struct index_node *nodes;
+    int                num_nodes,
+                       mask_words;       // uint64_ts per packed mask
+    int               *order;            // patterns in the order leaves refer to them
+    uint64_t          *mask_bits;        // num_patterns masks packed into bits
+};
+
+// memory one thread needs for searching
+struct search_scratch_t{
+    int            padded_columns, // block_columns
+                   quality;        // percentage, see search_scratch_create()
+    uint32_t      *d,              // tile_size rows of padded_columns
+                  *s,              // padded_columns
+                  *fg,             // padded_patterns rows of padded_columns
+                  *difference;     // tile_size rounded up to PLANAR_ALIGNMENT, one column of D while it's computed
+    // colors each tile of a block is scored with, tile b having columns tile_columns[b] to tile_columns[b + 1] - 1
+    int           *tile_columns,   // padded_columns + 1
+                  *column_colors;  // padded_columns + num_cols, color - col_min of each column
+    unsigned char *column_uses;    // padded_columns + num_cols, USE_COL1 | USE_COL2
+    // only used with the vantage point tree
+    unsigned long *pair_bases; // lowest possible difference with each pair of col1 and col2
+    int           *col1_columns,  // num_cols, columns of the tile that can be col1 / col2
+                  *col2_columns;
+    uint32_t      *weights,    // tile_size, how much worse the other color of the pair is for each pixel
+                  *weight_sums;// tile_size + 1, sums of the smallest k weights
+    uint64_t      *query_bits; // mask_words, where col1 of the pair is the better one
+    // only used without the vantage point tree and with a quality below 100
+    int           *nearest,      // tile_size, column of the color closest to each pixel
+                  *votes;        // num_cols, how many pixels each column is closest to
+    uint32_t      *nearest_diff; // tile_size, difference to that color
+};
+
+// a tile being looked up in the vantage point tree
+struct index_query{
+    int             column,    // first column of D for this tile
+                    count;     // and how many there are
+    unsigned long   base,      // lowest possible difference with the pair of colors currently looked at
+                    best_diff,
+                    threshold; // best_diff * quality / 100, anything whose lower bound is above it is skipped
+    search_result_t best;
+};
+
+// FG = M * D for the first columns columns of D (a multiple of KERNEL_COLUMNS)
+static void multiply(const search_t *restrict search, search_scratch_t *restrict scratch, int columns);
+// multiply for tiles of tile_size pixels, with a constant tile_size so the loops over pixels can be unrolled
+static inline void multiply_sized(const search_t *restrict search, search_scratch_t *restrict scratch, int columns, const int tile_size);
+// defines multiply_[tile_size], multiply for tiles of tile_size pixels
+#define DEFINE_MULTIPLY(tile_size) \
+    static void multiply_##tile_size(const search_t *restrict search, search_scratch_t *restrict scratch, int columns){ \
+        multiply_sized(search, scratch, columns, tile_size); \
+    }
+DEFINE_MULTIPLY(16)
+DEFINE_MULTIPLY(36)
+DEFINE_MULTIPLY(64)
+DEFINE_MULTIPLY(128)
+#undef DEFINE_MULTIPLY
+// multiply variants for the tile sizes everyone uses (4x4, 6x6, 8x8 and 8x16), with multiply for everything else
+static const struct{
+    int tile_size;
+    void (*multiply)(const search_t *restrict search, search_scratch_t *restrict scratch, int columns);
+} specialized[] = {
+    {16,  multiply_16},
+    {36,  multiply_36},
+    {64,  multiply_64},
+    {128, multiply_128},
+};
+// puts the difference between color and each pixel of the tile with planes of plane_size starting at tile into differences
+static void get_differences(uint32_t *restrict differences, const unsigned char *restrict tile, int plane_size, rgb24_t color);
+// puts the colors the tile with planes of plane_size starting at tile has to be scored with into colors and uses, returns how many there are
+static int select_colors(const search_t *restrict search, const unsigned char *restrict tile, int plane_size, int *restrict colors, unsigned char *restrict uses);
+// keeps only the quality percent of the count colors and uses of the tile at tile that are the closest to the most of its pixels, returns how many are left
+static int limit_colors(const search_t *restrict search, search_scratch_t *restrict scratch, const unsigned char *restrict tile, int plane_size, int *restrict colors, unsigned char *restrict uses, int count);
+// picks the best col1 and col2 for a pattern from the count columns of its row of FG and S of a tile, with colors and uses of those columns, returns its difference
+static unsigned long pick_colors(const search_t *restrict search, const uint32_t *restrict fg, const uint32_t *restrict s, const int *restrict colors, const unsigned char *restrict uses, int count, int *restrict col1, int *restrict col2);
+
+// does what search_create() does, only printing what it did if verbose
+static int create_search(search_t **search, int tile_width, int tile_height, int num_patterns, const unsigned char *masks,
+                         int num_colors, const rgb24_t *colors, int col1_min, int col1_max, int col2_min, int col2_max, int verbose);
+// packs masks into search->mask_bits, leaving out those that are the same as an earlier one, or its inverse if col1 and col2 can be swapped
+// puts the index of every pattern left into search->pattern_index and returns how many there are, -1 on failure
+static int canonicalize(search_t *restrict search, const unsigned char *restrict masks, int num_patterns, int *restrict inverses);
+// builds the vantage point tree over order[first] to order[first + count - 1] using entries for sorting, returns the index of its root node
+static int index_build(search_t *restrict search, struct index_entry *restrict entries, int first, int count);
+// compares two index_entrys by distance and then pattern
+static int compare_entries(const void *a, const void *b);
+// compares two uint32_ts
+static int compare_weights(const void *a, const void *b);
+// gets the hamming distance between two packed masks
+static int hamming(const uint64_t *a, const uint64_t *b, int words);
+// finds the best pattern of the tile at query->column using the vantage point tree
+static void index_search(const search_t *restrict search, search_scratch_t *restrict scratch, struct index_query *restrict query);
+// looks for patterns better than query->best using the colors of columns column1 and column2 of the tile, with base being the lowest possible difference using them
+static void index_search_pair(const search_t *restrict search, search_scratch_t *restrict scratch, struct index_query *restrict query, int column1, int column2, unsigned long base);
+// looks through node and its children for patterns better than query->best
+static void index_visit(const search_t *restrict search, search_scratch_t *restrict scratch, struct index_query *restrict query, int node_i);
+// checks whether something in node could still beat query->best, with bound being the lowest difference anything in it can have
+static int index_may_win(const search_t *restrict search, const struct index_query *restrict query, int node_i, unsigned long bound);
+// scores pattern if it can beat query->best
+static void index_score(const search_t *restrict search, search_scratch_t *restrict scratch, struct index_query *restrict query, int pattern);
+
+// creates a search over num_patterns masks of tile_width * tile_height bytes each (1 where col1 is used, 0 where col2 is)
+// col1 is picked from [col1_min, col1_max) and col2 from [col2_min, col2_max)
+// masks and colors are copied as needed, so they don't have to stay around
+// patterns the same as an earlier one (or its inverse, if col1 and col2 have the same range) are left out, since the earlier one always wins
+int search_create(search_t **search, int tile_width, int tile_height, int num_patterns, const unsigned char *masks,
+                  int num_colors, const rgb24_t *colors, int col1_min, int col1_max, int col2_min, int col2_max){
+    return create_search(search, tile_width, tile_height, num_patterns, masks, num_colors, colors, col1_min, col1_max, col2_min, col2_max, 1);
+}
+// does what search_create() does, only printing what it did if verbose
+static int create_search(search_t **search, int tile_width, int tile_height, int num_patterns, const unsigned char *masks,
+                         int num_colors, const rgb24_t *colors, int col1_min, int col1_max, int col2_min, int col2_max, int verbose){
+    if(num_patterns < 1 || col1_min >= col1_max || col2_min >= col2_max || col1_min < 0 || col2_min < 0 || col1_max > num_colors || col2_max > num_colors){
+        VERRPRINT(0, "Nothing to search through");
+        return 1;
+    }
+    search_t *s = malloc(sizeof(*s));
+    if(!s){
+        VERRPRINT(0, "Failed to allocate s");
+        return 1;
+    }
+    s->tile_size     = tile_width * tile_height;
+    s->col1_min      = col1_min;
+    s->col1_max      = col1_max;
+    s->col2_min      = col2_min;
+    s->col2_max      = col2_max;
+    s->col_min       = col1_min < col2_min ? col1_min : col2_min;
+    s->num_cols      = (col1_max > col2_max ? col1_max : col2_max) - s->col_min;
+    s->block_columns = (SEARCH_BLOCK_COLUMNS > s->num_cols ? SEARCH_BLOCK_COLUMNS : s->num_cols + KERNEL_COLUMNS - 1) / KERNEL_COLUMNS * KERNEL_COLUMNS;
+    s->multiply      = multiply;
+    for(size_t i = 0; i < sizeof(specialized) / sizeof(*specialized); ++i){
+        if(specialized[i].tile_size == s->tile_size) s->multiply = specialized[i].multiply;
+    }
+    s->masks         = NULL;
+    s->colors        = NULL;
+    s->pattern_index = NULL;
+    s->nodes         = NULL;
+    s->num_nodes     = 0;
+    s->mask_words    = (s->tile_size + 63) / 64;
+    s->order         = NULL;
+    s->mask_bits     = NULL;
+
+    // drop patterns that can never be picked
+    s->pattern_index = malloc(num_patterns * sizeof(*s->pattern_index));
+    s->mask_bits     = calloc((size_t)num_patterns * s->mask_words, sizeof(*s->mask_bits));
+    if(!s->pattern_index || !s->mask_bits){
+        VERRPRINT(0, "Failed to allocate s->pattern_index or s->mask_bits");
+        search_destroy(s);
+        return 1;
+    }
+    int inverses = 0;
+    s->num_patterns = canonicalize(s, masks, num_patterns, &inverses);
+    if(s->num_patterns < 0){
+        search_destroy(s);
+        return 1;
+    }
+    if(verbose) VPRINTF(2, "Dropped %i duplicate and %i inverse patterns, %i are left\n", num_patterns - s->num_patterns - inverses, inverses, s->num_patterns);
+    s->padded_patterns = (s->num_patterns + KERNEL_PATTERNS - 1) / KERNEL_PATTERNS * KERNEL_PATTERNS;
+
+    // copy masks, padding with empty ones
+    s->masks = calloc((size_t)s->padded_patterns * s->tile_size, 1);
+    if(!s->masks){
+        VERRPRINT(0, "Failed to allocate s->masks");
+        search_destroy(s);
+        return 1;
+    }
+    for(int p = 0; p < s->num_patterns; ++p){
+        const unsigned char *mask = masks + (size_t)s->pattern_index[p] * s->tile_size;
+        for(int i = 0; i < s->tile_size; ++i) s->masks[(size_t)p * s->tile_size + i] = mask[i] != 0;
+    }
+
+    // copy colors
+    s->colors = malloc(s->num_cols * sizeof(*s->colors));
+    if(!s->colors){
+        VERRPRINT(0, "Failed to allocate s->colors");
+        search_destroy(s);
+        return 1;
+    }
+    memcpy(s->colors, colors + s->col_min, s->num_cols * sizeof(*s->colors));
+
+    // build vantage point tree
+    if(s->num_patterns >= SEARCH_INDEX_MIN_PATTERNS){
+        struct index_entry *entries = malloc(s->num_patterns * sizeof(*entries));
+        s->nodes = malloc(s->num_patterns * sizeof(*s->nodes)); // every node but leaves uses up one pattern as its vantage point, so there can't be more
+        s->order = malloc(s->num_patterns * sizeof(*s->order));
+        if(!entries || !s->nodes || !s->order){
+            VERRPRINT(0, "Failed to allocate vantage point tree");
+            free(entries);
+            search_destroy(s);
+            return 1;
+        }
+        for(int p = 0; p < s->num_patterns; ++p) s->order[p] = p;
+        index_build(s, entries, 0, s->num_patterns);
+        free(entries);
+        if(verbose) VPRINTF(2, "Indexed %i patterns in %i nodes\n", s->num_patterns, s->num_nodes);
+    }
+    else{
+        free(s->mask_bits);
+        s->mask_bits = NULL;
+    }
+
+    *search = s;
+    return 0;
+}
+// creates coarse, a search over at most num_coarse of the patterns of search that are as different from each other as possible
+// it finds a close (but usually not the best) result for every tile much faster, results still refer to the patterns search was created with
+// coarse is NULL if search doesn't have more than num_coarse different patterns
+int search_create_coarse(search_t **coarse, const search_t *search, int num_coarse){
+    const int tile_size = search->tile_size,
+              swappable = search->col1_min == search->col2_min && search->col1_max == search->col2_max;
+    *coarse = NULL;
+    if(num_coarse >= search->num_patterns) return 0; // it would be search all over again
+    int           *picked    = malloc(num_coarse * sizeof(*picked)),
+                  *distances = malloc(search->num_patterns * sizeof(*distances));
+    unsigned char *masks     = malloc((size_t)num_coarse * tile_size);
+    rgb24_t       *colors    = calloc(search->col_min + search->num_cols, sizeof(*colors));
+    int            ret_code  = 1;
+    if(!picked || !distances || !masks || !colors){
+        VERRPRINT(0, "Failed to allocate memory for picking patterns");
+        goto _clean_and_exit;
+    }
+
+    // start with the first pattern, then keep picking whichever is furthest from all picked so far
+    for(int p = 0; p < search->num_patterns; ++p) distances[p] = INT_MAX;
+    int next = 0;
+    for(int k = 0; k < num_coarse; ++k){
+        const unsigned char *mask = search->masks + (size_t)next * tile_size;
+        picked[k] = next;
+        memcpy(masks + (size_t)k * tile_size, mask, tile_size);
+        next = 0;
+        for(int p = 0; p < search->num_patterns; ++p){
+            const unsigned char *other = search->masks + (size_t)p * tile_size;
+            int distance = 0;
+            for(int i = 0; i < tile_size; ++i) distance += mask[i] != other[i];
+            if(swappable && tile_size - distance < distance) distance = tile_size - distance; // an inverse is just as good if col1 and col2 can be swapped
+            if(distance < distances[p]) distances[p] = distance;
+            if(distances[p] > distances[next]) next = p;
+        }
+    }
+
+    // search over those, with results referring to the patterns search was created with
+    memcpy(colors + search->col_min, search->colors, search->num_cols * sizeof(*colors));
+    if(create_search(coarse, tile_size, 1, num_coarse, masks, search->col_min + search->num_cols, colors,
+                     search->col1_min, search->col1_max, search->col2_min, search->col2_max, 0)){
+        VERRPRINT(0, "Failed to create coarse");
+        goto _clean_and_exit;
+    }
+    for(int p = 0; p < (*coarse)->num_patterns; ++p) (*coarse)->pattern_index[p] = search->pattern_index[picked[(*coarse)->pattern_index[p]]];
+    ret_code = 0;
+
+_clean_and_exit:
+    free(picked);
+    free(distances);
+    free(masks);
+    free(colors);
+    return ret_code;
+}
+// destroyes search
+void search_destroy(search_t *search){
+    if(!search) return;
+    free(search->nodes);
+    free(search->order);
+    free(search->mask_bits);
+    free(search->pattern_index);
+    free(search->colors);
+    free(search->masks);
+    free(search);
+}
+
+// creates scratch memory for searching with search
+// with quality in [1, 100) (percent), patterns and colors that can't beat quality percent of the best difference found so far are skipped
+// making searches with the vantage point tree faster, at the cost of results being up to 100 / quality times worse than the best one
+// without the vantage point tree, only the quality percent of each tile's colors closest to the most of its pixels are scored instead
+// which makes it about that much faster, with no limit on how much worse results can get (though they rarely are by much)
+int search_scratch_create(search_scratch_t **scratch, const search_t *search, int quality){
+    search_scratch_t *s = malloc(sizeof(*s));
+    if(!s){
+        VERRPRINT(0, "Failed to allocate s");
+        return 1;
+    }
+    s->padded_columns = search->block_columns;
+    s->quality        = search_approximates(search, quality) ? quality : 100;
+    s->d             = calloc((size_t)search->tile_size * s->padded_columns, sizeof(*s->d));
+    s->s             = calloc(s->padded_columns, sizeof(*s->s));
+    s->fg            = malloc((size_t)search->padded_patterns * s->padded_columns * sizeof(*s->fg));
+    s->difference    = malloc((search->tile_size + PLANAR_ALIGNMENT - 1) / PLANAR_ALIGNMENT * PLANAR_ALIGNMENT * sizeof(*s->difference));
+    s->tile_columns  = malloc((s->padded_columns + 1) * sizeof(*s->tile_columns));
+    s->column_colors = malloc((s->padded_columns + search->num_cols) * sizeof(*s->column_colors));
+    s->column_uses   = malloc(s->padded_columns + search->num_cols);
+    s->pair_bases    = NULL;
+    s->col1_columns  = NULL;
+    s->col2_columns  = NULL;
+    s->weights     = NULL;
+    s->weight_sums = NULL;
+    s->query_bits  = NULL;
+    s->nearest      = NULL;
+    s->votes        = NULL;
+    s->nearest_diff = NULL;
+    if(!search->nodes && s->quality < 100){
+        s->nearest      = malloc(search->tile_size * sizeof(*s->nearest));
+        s->votes        = malloc(search->num_cols * sizeof(*s->votes));
+        s->nearest_diff = malloc(search->tile_size * sizeof(*s->nearest_diff));
+        if(!s->nearest || !s->votes || !s->nearest_diff){
+            VERRPRINT(0, "Failed to allocate scratch memory");
+            search_scratch_destroy(s);
+            return 1;
+        }
+    }
+    if(search->nodes){
+        s->pair_bases  = malloc((size_t)(search->col1_max - search->col1_min) * (search->col2_max - search->col2_min) * sizeof(*s->pair_bases));
+        s->col1_columns = malloc(search->num_cols * sizeof(*s->col1_columns));
+        s->col2_columns = malloc(search->num_cols * sizeof(*s->col2_columns));
+        s->weights     = malloc(search->tile_size * sizeof(*s->weights));
+        s->weight_sums = malloc((search->tile_size + 1) * sizeof(*s->weight_sums));
+        s->query_bits  = malloc(search->mask_words * sizeof(*s->query_bits));
+        if(!s->pair_bases || !s->col1_columns || !s->col2_columns || !s->weights || !s->weight_sums || !s->query_bits){
+            VERRPRINT(0, "Failed to allocate scratch memory");
+            search_scratch_destroy(s);
+            return 1;
+        }
+    }
+    if(!s->d || !s->s || !s->fg || !s->difference || !s->tile_columns || !s->column_colors || !s->column_uses){
+        VERRPRINT(0, "Failed to allocate scratch memory");
+        search_scratch_destroy(s);
+        return 1;
+    }
+    *scratch = s;
+    return 0;
+}
+// destroyes scratch
+void search_scratch_destroy(search_scratch_t *scratch){
+    if(!scratch) return;
+    free(scratch->d);
+    free(scratch->s);
+    free(scratch->fg);
+    free(scratch->difference);
+    free(scratch->tile_columns);
+    free(scratch->column_colors);
+    free(scratch->column_uses);
+    free(scratch->pair_bases);
+    free(scratch->col1_columns);
+    free(scratch->col2_columns);
+    free(scratch->weights);
+    free(scratch->weight_sums);
+    free(scratch->query_bits);
+    free(scratch->nearest);
+    free(scratch->votes);
+    free(scratch->nearest_diff);
+    free(scratch);
+}
+// returns whether searching with search and quality can find different (and so worse) results than searching exactly, and with that be any faster
+int search_approximates(const search_t *search, int quality){
+    if(quality < 1 || quality >= 100) return 0;
+    if(search->nodes) return 1;
+    if(search->num_patterns < SEARCH_LIMIT_COLORS_MIN_PATTERNS) return 0;
+    // limit_colors() keeps at least 2 colors, and no tile has more than num_cols
+    const int limit = (search->num_cols * quality + 99) / 100;
+    return (limit > 2 ? limit : 2) < search->num_cols;
+}
+
+// finds the best pattern and colors for each of the num_tiles tiles of tiles starting at first_tile into results
+// if tile_indices is not NULL, the tiles searched are tile_indices[first_tile] to tile_indices[first_tile + num_tiles - 1] instead
+// gives the same result as trying every pattern, col1 and col2 in that order and keeping the first one with the lowest difference, unless scratch was created with a quality below 100
+void search_tiles(const search_t *search, search_scratch_t *scratch, const planar_atlas_t *tiles, const int *tile_indices, int first_tile, int num_tiles, search_result_t *results){
+    const int tile_size  = search->tile_size,
+              stride     = scratch->padded_columns,
+              plane_size = tiles->plane_size;
+    int block_tiles;
+    for(int t0 = 0; t0 < num_tiles; t0 += block_tiles){
+        // as many tiles as their colors fit in a block
+        int used = 0;
+        for(block_tiles = 0; t0 + block_tiles < num_tiles; ++block_tiles){
+            const int            t     = first_tile + t0 + block_tiles;
+            const unsigned char *tile  = tiles->data + (size_t)(tile_indices ? tile_indices[t] : t) * 3 * plane_size;
+            int                  count = select_colors(search, tile, plane_size, scratch->column_colors + used, scratch->column_uses + used);
+            if(scratch->nearest) count = limit_colors(search, scratch, tile, plane_size, scratch->column_colors + used, scratch->column_uses + used, count);
+            if(used + count > search->block_columns) break;
+            scratch->tile_columns[block_tiles] = used;
+            used += count;
+        }
+        scratch->tile_columns[block_tiles] = used;
+        const int columns = (used + KERNEL_COLUMNS - 1) / KERNEL_COLUMNS * KERNEL_COLUMNS;
+
+        // D and S, one column at a time over the planes of its tile, columns past the last tile stay 0
+        for(int b = 0; b < block_tiles; ++b){
+            const int            t    = first_tile + t0 + b;
+            const unsigned char *tile = tiles->data + (size_t)(tile_indices ? tile_indices[t] : t) * 3 * plane_size;
+            for(int j = scratch->tile_columns[b]; j < scratch->tile_columns[b + 1]; ++j){
+                get_differences(scratch->difference, tile, plane_size, search->colors[scratch->column_colors[j]]);
+                uint32_t sum = 0;
+                for(int i = 0; i < tile_size; ++i){
+                    scratch->d[(size_t)i * stride + j] = scratch->difference[i];
+                    sum += scratch->difference[i];
+                }
+                scratch->s[j] = sum;
+            }
+        }
+        for(int i = 0; i < tile_size; ++i){
+            for(int j = used; j < columns; ++j) scratch->d[(size_t)i * stride + j] = 0;
+        }
+        for(int j = used; j < columns; ++j) scratch->s[j] = 0;
+
+        // look each tile up in the vantage point tree
+        if(search->nodes){
+            for(int b = 0; b < block_tiles; ++b){
+                struct index_query query = {scratch->tile_columns[b], scratch->tile_columns[b + 1] - scratch->tile_columns[b], 0, ULONG_MAX, ULONG_MAX, {search->num_patterns, 0, 0, 0}};
+                index_search(search, scratch, &query);
+                results[t0 + b]            = query.best;
+                results[t0 + b].pattern    = search->pattern_index[query.best.pattern];
+                results[t0 + b].difference = query.best_diff;
+            }
+            continue;
+        }
+
+        // FG
+        search->multiply(search, scratch, columns);
+
+        // pick best pattern and colors of each tile
+        for(int b = 0; b < block_tiles; ++b){
+            const int first = scratch->tile_columns[b],
+                      count = scratch->tile_columns[b + 1] - first;
+            unsigned long lowest_diff = ULONG_MAX;
+            search_result_t best = {0, 0, 0, 0};
+            for(int pt_i = 0; pt_i < search->num_patterns; ++pt_i){
+                int col1,
+                    col2;
+                const unsigned long difference = pick_colors(search, scratch->fg + (size_t)pt_i * stride + first, scratch->s + first,
+                                                             scratch->column_colors + first, scratch->column_uses + first, count, &col1, &col2);
+                if(difference < lowest_diff){
+                    lowest_diff  = difference;
+                    best.pattern = pt_i;
+                    best.col1    = col1;
+                    best.col2    = col2;
+                }
+            }
+            results[t0 + b]            = best;
+            results[t0 + b].pattern    = search->pattern_index[best.pattern];
+            results[t0 + b].difference = lowest_diff;
+        }
+    }
+}
+
+// puts the difference between color and each pixel of the tile with planes of plane_size starting at tile into differences
+static void get_differences(uint32_t *restrict differences, const unsigned char *restrict tile, int plane_size, rgb24_t color){
+    const unsigned char *r = tile,
+                        *g = tile + plane_size,
+                        *b = tile + 2 * plane_size;
+    for(int i0 = 0; i0 < plane_size; i0 += PLANAR_ALIGNMENT){
+        for(int i = i0; i < i0 + PLANAR_ALIGNMENT; ++i){ // a constant number of iterations, so it can be vectorized as is
+            differences[i] = abs(color.r - (int)r[i]) + abs(color.g - (int)g[i]) + abs(color.b - (int)b[i]);
+        }
+    }
+}
+// puts the colors the tile with planes of plane_size starting at tile has to be scored with into colors and uses, returns how many there are
+// for any pixel in the bounding box of tile, a color with min_distance greater than the max_distance of another is always worse
+// so it can never be the best col1 or col2 of a pattern, except when all of them are equally good with no pixels using them, where the first one is picked
+static int select_colors(const search_t *restrict search, const unsigned char *restrict tile, int plane_size, int *restrict colors, unsigned char *restrict uses){
+    int lo[3],
+        hi[3];
+    for(int ch = 0; ch < 3; ++ch){
+        const unsigned char *plane = tile + ch * plane_size;
+        unsigned char plane_lo = 255,
+                      plane_hi = 0;
+        for(int i0 = 0; i0 < plane_size; i0 += PLANAR_ALIGNMENT){ // padding repeats the last pixel, so it changes nothing
+            for(int i = i0; i < i0 + PLANAR_ALIGNMENT; ++i){
+                plane_lo = plane[i] < plane_lo ? plane[i] : plane_lo;
+                plane_hi = plane[i] > plane_hi ? plane[i] : plane_hi;
+            }
+        }
+        lo[ch] = plane_lo;
+        hi[ch] = plane_hi;
+    }
+
+    // no color can be further from any pixel than the one with the lowest max_distance
+    int threshold1 = INT_MAX,
+        threshold2 = INT_MAX;
+    for(int c = 0; c < search->num_cols; ++c){
+        const int channels[3] = {search->colors[c].r, search->colors[c].g, search->colors[c].b};
+        int max_distance = 0;
+        for(int ch = 0; ch < 3; ++ch) max_distance += channels[ch] - lo[ch] > hi[ch] - channels[ch] ? channels[ch] - lo[ch] : hi[ch] - channels[ch];
+        const int color = c + search->col_min;
+        if(color >= search->col1_min && color < search->col1_max && max_distance < threshold1) threshold1 = max_distance;
+        if(color >= search->col2_min && color < search->col2_max && max_distance < threshold2) threshold2 = max_distance;
+    }
+
+    int count = 0;
+    for(int c = 0; c < search->num_cols; ++c){
+        const int channels[3] = {search->colors[c].r, search->colors[c].g, search->colors[c].b};
+        int min_distance = 0;
+        for(int ch = 0; ch < 3; ++ch){
+            if(channels[ch] < lo[ch]) min_distance += lo[ch] - channels[ch];
+            else if(channels[ch] > hi[ch]) min_distance += channels[ch] - hi[ch];
+        }
+        const int color = c + search->col_min;
+        unsigned char use = 0;
+        if(color >= search->col1_min && color < search->col1_max && (min_distance <= threshold1 || color == search->col1_min)) use |= USE_COL1;
+        if(color >= search->col2_min && color < search->col2_max && (min_distance <= threshold2 || color == search->col2_min)) use |= USE_COL2;
+        if(!use) continue;
+        colors[count] = c;
+        uses[count]   = use;
+        ++count;
+    }
+    return count;
+}
+
+// keeps only the quality percent of the count colors and uses of the tile at tile that are the closest to the most of its pixels, returns how many are left
+// a pattern's best colors are usually the ones closest to the pixels on either side of it, so the others are rarely missed
+static int limit_colors(const search_t *restrict search, search_scratch_t *restrict scratch, const unsigned char *restrict tile, int plane_size, int *restrict colors, unsigned char *restrict uses, int count){
+    int limit = (count * scratch->quality + 99) / 100;
+    if(limit < 2) limit = 2;
+    if(count <= limit) return count;
+
+    // count how many pixels each color is the closest one to
+    for(int i = 0; i < search->tile_size; ++i) scratch->nearest_diff[i] = UINT32_MAX;
+    for(int j = 0; j < count; ++j){
+        get_differences(scratch->difference, tile, plane_size, search->colors[colors[j]]);
+        for(int i = 0; i < search->tile_size; ++i){
+            if(scratch->difference[i] < scratch->nearest_diff[i]){
+                scratch->nearest_diff[i] = scratch->difference[i];
+                scratch->nearest[i]      = j;
+            }
+        }
+        scratch->votes[j] = 0;
+    }
+    for(int i = 0; i < search->tile_size; ++i) ++scratch->votes[scratch->nearest[i]];
+
+    // keep the limit colors with the most of them (marked with a vote of -1), and the best one that can be col1 / col2 if none of those can
+    unsigned char kept_uses = 0;
+    for(int k = 0; k < limit + 2; ++k){
+        const unsigned char needed = k < limit ? USE_COL1 | USE_COL2 : k == limit ? USE_COL1 : USE_COL2;
+        if(k >= limit && (kept_uses & needed)) continue;
+        int best = -1;
+        for(int j = 0; j < count; ++j){
+            if(scratch->votes[j] >= 0 && (uses[j] & needed) && (best < 0 || scratch->votes[j] > scratch->votes[best])) best = j;
+        }
+        if(best < 0) continue;
+        scratch->votes[best] = -1;
+        kept_uses |= uses[best];
+    }
+
+    // in their original order, so ties are still broken the same way
+    int kept = 0;
+    for(int j = 0; j < count; ++j){
+        if(scratch->votes[j] >= 0) continue;
+        colors[kept] = colors[j];
+        uses[kept]   = uses[j];
+        ++kept;
+    }
+    return kept;
+}
+// picks the best col1 and col2 for a pattern from the count columns of its row of FG and S of a tile, with colors and uses of those columns, returns its difference
+static unsigned long pick_colors(const search_t *restrict search, const uint32_t *restrict fg, const uint32_t *restrict s, const int *restrict colors, const unsigned char *restrict uses, int count, int *restrict col1, int *restrict col2){
+    uint32_t lowest_fg = UINT32_MAX,
+             lowest_bg = UINT32_MAX;
+    *col1 = 0;
+    *col2 = 0;
+    for(int j = 0; j < count; ++j){
+        if((uses[j] & USE_COL1) && fg[j] < lowest_fg){
+            lowest_fg = fg[j];
+            *col1     = colors[j] + search->col_min;
+        }
+        const uint32_t bg = s[j] - fg[j];
+        if((uses[j] & USE_COL2) && bg < lowest_bg){
+            lowest_bg = bg;
+            *col2     = colors[j] + search->col_min;
+        }
+    }
+    return (unsigned long)lowest_fg + lowest_bg;
+}
+
+// FG = M * D for the first columns columns of D (a multiple of KERNEL_COLUMNS)
+static void multiply(const search_t *restrict search, search_scratch_t *restrict scratch, int columns){
+    multiply_sized(search, scratch, columns, search->tile_size);
+}
+// multiply for tiles of tile_size pixels, with a constant tile_size so the loops over pixels can be unrolled
+static inline void multiply_sized(const search_t *restrict search, search_scratch_t *restrict scratch, int columns, const int tile_size){
+    const int stride = scratch->padded_columns;
+    for(int p0 = 0; p0 < search->padded_patterns; p0 += KERNEL_PATTERNS){
+        const unsigned char *masks = search->masks + (size_t)p0 * tile_size;
+        for(int j0 = 0; j0 < columns; j0 += KERNEL_COLUMNS){
+            // KERNEL_PATTERNS x KERNEL_COLUMNS block of FG, summed up over all pixels
+            uint32_t acc[KERNEL_PATTERNS][KERNEL_COLUMNS] = {{0}};
+            for(int i = 0; i < tile_size; ++i){
+                const uint32_t *d = scratch->d + (size_t)i * stride + j0;
+                for(int p = 0; p < KERNEL_PATTERNS; ++p){
+                    const uint32_t m = -(uint32_t)masks[p * tile_size + i]; // all bits set where the mask is, so no multiplication is needed
+                    for(int j = 0; j < KERNEL_COLUMNS; ++j){
+                        acc[p][j] += m & d[j];
+                    }
+                }
+            }
+            for(int p = 0; p < KERNEL_PATTERNS; ++p){
+                memcpy(scratch->fg + (size_t)(p0 + p) * stride + j0, acc[p], sizeof(acc[p]));
+            }
+        }
+    }
+}
+
+// packs masks into search->mask_bits, leaving out those that are the same as an earlier one, or its inverse if col1 and col2 can be swapped
+// puts the index of every pattern left into search->pattern_index and returns how many there are, -1 on failure
+static int canonicalize(search_t *restrict search, const unsigned char *restrict masks, int num_patterns, int *restrict inverses){
+    const int      words     = search->mask_words,
+                   swappable = search->col1_min == search->col2_min && search->col1_max == search->col2_max;
+    const uint64_t last_word = search->tile_size % 64 ? ((uint64_t)1 << (search->tile_size % 64)) - 1 : ~(uint64_t)0;
+
+    // hash table of the patterns kept so far, -1 being empty
+    int table_size = 1;
+    while(table_size < 2 * num_patterns) table_size *= 2;
+    int *table = malloc(table_size * sizeof(*table));
+    if(!table){
+        VERRPRINT(0, "Failed to allocate table");
+        return -1;
+    }
+    for(int i = 0; i < table_size; ++i) table[i] = -1;
+
+    int kept = 0;
+    *inverses = 0;
+    for(int p = 0; p < num_patterns; ++p){
+        // pack into the next free spot, where it is overwritten again if it's dropped
+        uint64_t *bits = search->mask_bits + (size_t)kept * search->mask_words;
+        memset(bits, 0, words * sizeof(*bits));
+        for(int i = 0; i < search->tile_size; ++i){
+            if(masks[(size_t)p * search->tile_size + i]) bits[i / 64] |= (uint64_t)1 << (i % 64);
+        }
+
+        // patterns and their inverses hash the same, by always hashing the one with the first pixel unset
+        const uint64_t flip = swappable && (bits[0] & 1) ? ~(uint64_t)0 : 0;
+        uint64_t hash = 0xcbf29ce484222325u;
+        for(int w = 0; w < words; ++w){
+            hash ^= (bits[w] ^ flip) & (w == words - 1 ? last_word : ~(uint64_t)0);
+            hash *= 0x100000001b3u;
+        }
+
+        int slot = (int)(hash & (uint64_t)(table_size - 1)),
+            same = 0;
+        for(; table[slot] >= 0; slot = (slot + 1) & (table_size - 1)){
+            const uint64_t *other = search->mask_bits + (size_t)table[slot] * words;
+            int equal   = 1,
+                inverse = swappable;
+            for(int w = 0; w < words; ++w){
+                const uint64_t mask = w == words - 1 ? last_word : ~(uint64_t)0;
+                if((bits[w] ^ other[w]) & mask) equal = 0;
+                if((~bits[w] ^ other[w]) & mask) inverse = 0;
+            }
+            if(equal || inverse){
+                same       = 1;
+                *inverses += !equal;
+                break;
+            }
+        }
+        if(same) continue;
+        table[slot]                 = kept;
+        search->pattern_index[kept] = p;
+        ++kept;
+    }
+    free(table);
+    return kept;
+}
+
+// builds the vantage point tree over order[first] to order[first + count - 1] using entries for sorting, returns the index of its root node
+static int index_build(search_t *restrict search, struct index_entry *restrict entries, int first, int count){
+    const int node_i = search->num_nodes++;
+    struct index_node *node = &search->nodes[node_i];
+    node->vantage = -1;
+    node->first   = first;
+    node->count   = count;
+    node->lowest  = search->order[first];
+    node->inside  = -1;
+    node->outside = -1;
+    for(int i = 1; i < count; ++i) if(search->order[first + i] < node->lowest) node->lowest = search->order[first + i];
+    if(count <= INDEX_LEAF_SIZE) return node_i;
+
+    // sort everything but the vantage point by its distance to it
+    const int       vantage = search->order[first];
+    const uint64_t *v_bits  = search->mask_bits + (size_t)vantage * search->mask_words;
+    for(int i = 1; i < count; ++i){
+        const int pattern = search->order[first + i];
+        entries[i - 1].distance = hamming(v_bits, search->mask_bits + (size_t)pattern * search->mask_words, search->mask_words);
+        entries[i - 1].pattern  = pattern;
+    }
+    qsort(entries, count - 1, sizeof(*entries), compare_entries);
+    for(int i = 1; i < count; ++i) search->order[first + i] = entries[i - 1].pattern;
+
+    // split in half, closer ones inside
+    const int inside_count  = (count - 1) / 2,
+              outside_count = count - 1 - inside_count;
+    node->vantage     = vantage;
+    node->inside_min  = entries[0].distance;
+    node->inside_max  = entries[inside_count - 1].distance;
+    node->outside_min = entries[inside_count].distance;
+    node->outside_max = entries[count - 2].distance;
+    node->inside      = index_build(search, entries, first + 1, inside_count);
+    node->outside     = index_build(search, entries, first + 1 + inside_count, outside_count);
+    return node_i;
+}
+// compares two index_entrys by distance and then pattern
+static int compare_entries(const void *a, const void *b){
+    const struct index_entry *ea = a,
+                             *eb = b;
+    if(ea->distance != eb->distance) return ea->distance < eb->distance ? -1 : 1;
+    return (ea->pattern > eb->pattern) - (ea->pattern < eb->pattern);
+}
+// compares two uint32_ts
+static int compare_weights(const void *a, const void *b){
+    const uint32_t wa = *(const uint32_t*)a,
+                   wb = *(const uint32_t*)b;
+    return (wa > wb) - (wa < wb);
+}
+// gets the hamming distance between two packed masks
+static int hamming(const uint64_t *a, const uint64_t *b, int words){
+    int distance = 0;
+    for(int w = 0; w < words; ++w){
+        uint64_t x = a[w] ^ b[w];
+        x = x - ((x >> 1) & 0x5555555555555555u);
+        x = (x & 0x3333333333333333u) + ((x >> 2) & 0x3333333333333333u);
+        x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fu;
+        distance += (int)((x * 0x0101010101010101u) >> 56);
+    }
+    return distance;
+}
+
+// finds the best pattern of the tile at query->column using the vantage point tree
+static void index_search(const search_t *restrict search, search_scratch_t *restrict scratch, struct index_query *restrict query){
+    const int            tile_size = search->tile_size,
+                         stride    = scratch->padded_columns;
+    const int           *colors    = scratch->column_colors + query->column;
+    const unsigned char *uses      = scratch->column_uses + query->column;
+
+    // columns of the tile that can be col1 and col2
+    int num_col1 = 0,
+        num_col2 = 0;
+    for(int j = 0; j < query->count; ++j){
+        if(uses[j] & USE_COL1) scratch->col1_columns[num_col1++] = j;
+        if(uses[j] & USE_COL2) scratch->col2_columns[num_col2++] = j;
+    }
+    const int num_pairs = num_col1 * num_col2;
+
+    // no pattern can do better with a pair of colors than every pixel taking the closer one
+    unsigned long *bases = scratch->pair_bases;
+    memset(bases, 0, num_pairs * sizeof(*bases));
+    for(int i = 0; i < tile_size; ++i){
+        const uint32_t *d = scratch->d + (size_t)i * stride + query->column;
+        for(int j1 = 0, pair = 0; j1 < num_col1; ++j1){
+            const uint32_t d1 = d[scratch->col1_columns[j1]];
+            for(int j2 = 0; j2 < num_col2; ++j2, ++pair){
+                const uint32_t d2 = d[scratch->col2_columns[j2]];
+                bases[pair] += d1 < d2 ? d1 : d2;
+            }
+        }
+    }
+
+    // look through the most promising pair first, so the rest can mostly be skipped
+    int first = 0;
+    for(int pair = 1; pair < num_pairs; ++pair) if(bases[pair] < bases[first]) first = pair;
+    for(int i = -1; i < num_pairs; ++i){
+        const int pair = i < 0 ? first : i;
+        if((i >= 0 && pair == first) || bases[pair] > query->threshold) continue;
+        index_search_pair(search, scratch, query, scratch->col1_columns[pair / num_col2], scratch->col2_columns[pair % num_col2], bases[pair]);
+    }
+
+    // colors of the best pattern, the same as if it had been scored with all of them
+    uint32_t *fg = scratch->fg;
+    memset(fg, 0, query->count * sizeof(*fg));
+    const unsigned char *mask = search->masks + (size_t)query->best.pattern * tile_size;
+    for(int i = 0; i < tile_size; ++i){
+        if(!mask[i]) continue;
+        const uint32_t *d = scratch->d + (size_t)i * stride + query->column;
+        for(int j = 0; j < query->count; ++j) fg[j] += d[j];
+    }
+    query->best_diff = pick_colors(search, fg, scratch->s + query->column, colors, uses, query->count, &query->best.col1, &query->best.col2);
+}
+// looks for patterns better than query->best using the colors of columns column1 and column2 of the tile, with base being the lowest possible difference using them
+static void index_search_pair(const search_t *restrict search, search_scratch_t *restrict scratch, struct index_query *restrict query, int column1, int column2, unsigned long base){
+    const int tile_size = search->tile_size,
+              stride    = scratch->padded_columns;
+
+    // with col1 and col2 fixed, a pattern's difference is base plus the weights of the pixels it disagrees with query_bits on
+    memset(scratch->query_bits, 0, search->mask_words * sizeof(*scratch->query_bits));
+    for(int i = 0; i < tile_size; ++i){
+        const uint32_t *d  = scratch->d + (size_t)i * stride + query->column;
+        const uint32_t  d1 = d[column1],
+                        d2 = d[column2];
+        if(d1 < d2){
+            scratch->query_bits[i / 64] |= (uint64_t)1 << (i % 64);
+            scratch->weights[i] = d2 - d1;
+        }
+        else scratch->weights[i] = d1 - d2;
+    }
+
+    // so patterns disagreeing with it in k pixels have at least the k smallest weights on top of base
+    memcpy(scratch->weight_sums, scratch->weights, tile_size * sizeof(*scratch->weights));
+    qsort(scratch->weight_sums, tile_size, sizeof(*scratch->weight_sums), compare_weights);
+    uint32_t sum = 0;
+    for(int k = 0; k < tile_size; ++k){
+        const uint32_t w = scratch->weight_sums[k];
+        scratch->weight_sums[k] = sum;
+        sum += w;
+    }
+    scratch->weight_sums[tile_size] = sum;
+
+    query->base = base;
+    index_visit(search, scratch, query, 0);
+}
+// looks through node and its children for patterns better than query->best
+static void index_visit(const search_t *restrict search, search_scratch_t *restrict scratch, struct index_query *restrict query, int node_i){
+    const struct index_node *node = &search->nodes[node_i];
+    if(node->vantage < 0){
+        for(int i = 0; i < node->count; ++i) index_score(search, scratch, query, search->order[node->first + i]);
+        return;
+    }
+    index_score(search, scratch, query, node->vantage);
+
+    // every pattern in a child is at least |distance - distance to vantage| away from query_bits
+    const int distance = hamming(search->mask_bits + (size_t)node->vantage * search->mask_words, scratch->query_bits, search->mask_words);
+    int inside_k  = distance - node->inside_max,
+        outside_k = distance - node->outside_max;
+    if(node->inside_min - distance > inside_k) inside_k = node->inside_min - distance;
+    if(node->outside_min - distance > outside_k) outside_k = node->outside_min - distance;
+    const unsigned long inside_bound  = query->base + scratch->weight_sums[inside_k > 0 ? inside_k : 0],
+                        outside_bound = query->base + scratch->weight_sums[outside_k > 0 ? outside_k : 0];
+
+    // closer child first
+    if(node->inside >= 0 && inside_bound <= outside_bound){
+        if(index_may_win(search, query, node->inside, inside_bound)) index_visit(search, scratch, query, node->inside);
+        if(index_may_win(search, query, node->outside, outside_bound)) index_visit(search, scratch, query, node->outside);
+    }
+    else{
+        if(index_may_win(search, query, node->outside, outside_bound)) index_visit(search, scratch, query, node->outside);
+        if(node->inside >= 0 && index_may_win(search, query, node->inside, inside_bound)) index_visit(search, scratch, query, node->inside);
+    }
+}
+// checks whether something in node could still beat query->best, with bound being the lowest difference anything in it can have
+static int index_may_win(const search_t *restrict search, const struct index_query *restrict query, int node_i, unsigned long bound){
+    return bound < query->threshold || (bound == query->threshold && search->nodes[node_i].lowest < query->best.pattern);
+}
+// scores pattern if it can beat query->best
+static void index_score(const search_t *restrict search, search_scratch_t *restrict scratch, struct index_query *restrict query, int pattern){
+    if(pattern > query->best.pattern && query->base >= query->threshold) return;
+    const uint64_t *bits = search->mask_bits + (size_t)pattern * search->mask_words;
+
+    // lower bound by how many pixels disagree first, then by which ones, which is exact
+    const int distance = hamming(bits, scratch->query_bits, search->mask_words);
+    if(query->base + scratch->weight_sums[distance] > query->threshold) return;
+    unsigned long difference = query->base;
+    for(int w = 0; w < search->mask_words; ++w){
+        const uint64_t disagree = bits[w] ^ scratch->query_bits[w];
+        if(!disagree) continue;
+        const int end = search->tile_size - w * 64 < 64 ? search->tile_size - w * 64 : 64;
+        for(int i = 0; i < end; ++i) if((disagree >> i) & 1) difference += scratch->weights[w * 64 + i];
+    }
+    if(difference < query->best_diff || (difference == query->best_diff && pattern < query->best.pattern)){
+        query->best_diff    = difference;
+        query->threshold    = difference * scratch->quality / 100;
+        query->best.pattern = pattern;
+    }
+}
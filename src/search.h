@@ -0,0 +1,107 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#ifndef SEARCH_H__
+#define SEARCH_H__
+
+#include "rgb24.h"
+#include "atlas.h"
+
+// finds the best pattern and colors for tiles
+//
+// with D[i][c] the difference between pixel i of a tile and color c, S[c] the sum of D[i][c] over all pixels
+// and FG[p][c] = sum over i of mask[p][i] * D[i][c] (or FG = M * D as matricies),
+// the difference of pattern p drawn with col1 and col2 is FG[p][col1] + S[col2] - FG[p][col2]
+// so the best col1 and col2 for a pattern can be picked separately, and FG for a whole block of tiles is one matrix multiplication
+// colors that are further from every pixel in a tile's bounding box than some other color can never be picked, so they get no columns for that tile
+typedef struct search_t search_t;
+
+// memory one thread needs for searching
+typedef struct search_scratch_t search_scratch_t;
+
+// best pattern and colors for a tile
+typedef struct search_result_t{
+    int           pattern,
+                  col1,
+                  col2;
+    unsigned long difference; // sum of the differences of all pixels of the tile drawn like this
+} search_result_t;
+
+// how many columns of D (tiles * colors) are scored at once
+#ifndef SEARCH_BLOCK_COLUMNS
+    #define SEARCH_BLOCK_COLUMNS 64
+#endif
+
+// from how many patterns on they are put into a vantage point tree over the hamming distances between their masks
+// with col1 and col2 fixed, a pattern's difference is sum of min(D[i][col1], D[i][col2]) plus |D[i][col1] - D[i][col2]| for every pixel
+// where its mask disagrees with the tile thresholded between those colors, so whole subtrees too far away from that can be skipped
+#ifndef SEARCH_INDEX_MIN_PATTERNS
+    #define SEARCH_INDEX_MIN_PATTERNS 128
+#endif
+
+// from how many patterns on a quality below 100 limits the colors tiles are scored with when there's no vantage point tree
+// with fewer, finding the colors to keep takes about as long as scoring the others would
+#ifndef SEARCH_LIMIT_COLORS_MIN_PATTERNS
+    #define SEARCH_LIMIT_COLORS_MIN_PATTERNS 16
+#endif
+
+// creates a search over num_patterns masks of tile_width * tile_height bytes each (1 where col1 is used, 0 where col2 is)
+// col1 is picked from [col1_min, col1_max) and col2 from [col2_min, col2_max)
+// masks and colors are copied as needed, so they don't have to stay around
+// patterns the same as an earlier one (or its inverse, if col1 and col2 have the same range) are left out, since the earlier one always wins
+int search_create(search_t **search, int tile_width, int tile_height, int num_patterns, const unsigned char *masks,
+                  int num_colors, const rgb24_t *colors, int col1_min, int col1_max, int col2_min, int col2_max);
+// creates coarse, a search over at most num_coarse of the patterns of search that are as different from each other as possible
+// it finds a close (but usually not the best) result for every tile much faster, results still refer to the patterns search was created with
+// coarse is NULL if search doesn't have more than num_coarse different patterns
+int search_create_coarse(search_t **coarse, const search_t *search, int num_coarse);
+// destroyes search
+void search_destroy(search_t *search);
+
+// creates scratch memory for searching with search
+// with quality in [1, 100) (percent), patterns and colors that can't beat quality percent of the best difference found so far are skipped
+// making searches with the vantage point tree faster, at the cost of results being up to 100 / quality times worse than the best one
+// without the vantage point tree, only the quality percent of each tile's colors closest to the most of its pixels are scored instead
+// which makes it about that much faster, with no limit on how much worse results can get (though they rarely are by much)
+int search_scratch_create(search_scratch_t **scratch, const search_t *search, int quality);
+// destroyes scratch
+void search_scratch_destroy(search_scratch_t *scratch);
+// returns whether searching with search and quality can find different (and so worse) results than searching exactly, and with that be any faster
+int search_approximates(const search_t *search, int quality);
+
+// finds the best pattern and colors for each of the num_tiles tiles of tiles starting at first_tile into results
+// if tile_indices is not NULL, the tiles searched are tile_indices[first_tile] to tile_indices[first_tile + num_tiles - 1] instead
+// gives the same result as trying every pattern, col1 and col2 in that order and keeping the first one with the lowest difference, unless scratch was created with a quality below 100
+void search_tiles(const search_t *search, search_scratch_t *scratch, const planar_atlas_t *tiles, const int *tile_indices, int first_tile, int num_tiles, search_result_t *results);
+
+#endif
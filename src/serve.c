@@ -0,0 +1,652 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#if defined(__unix__)
+    #define _POSIX_C_SOURCE 200809L
+#endif
+#include "serve.h"
+
+#if SERVE_SUPPORTED
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <string.h>
+    #include <errno.h>
+    #include <signal.h>
+    #include <stdatomic.h>
+    #include <sys/types.h>
+    #include <sys/stat.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+    #include "load_png.h"
+    #include "print.h"
+    #include "texture.h"
+    #include "thread_pool.h"
+    #include "tilize.h"
+    #include "timing.h"
+    #include "tinycthread.h"
+
+    // longest line accepted in a request
+    #define MAX_LINE 4096
+    // largest raw image accepted, in pixels
+    #define MAX_RAW_PIXELS (1L << 28)
+
+    // a loaded configuration
+    struct cache_entry{
+        char             *config_path; // NULL for the default configuration
+        time_t            mtime;       // of config_path when it was loaded
+        tilize_context_t *context;     // NULL if entry is unused
+        int               refs;        // requests currently using context
+        unsigned long     last_used;
+    };
+
+    // server state
+    static volatile sig_atomic_t stop_requested;
+    static atomic_int            running;
+    static thread_pool_t        *pool;
+    static struct cache_entry    cache[SERVE_CACHE_SIZE];
+    static unsigned long         cache_clock;
+    static mtx_t                 cache_mtx;
+    static int                   connections[SERVE_MAX_CONNECTIONS]; // -1 if unused
+    static int                   num_connections;
+    static mtx_t                 connections_mtx;
+    static cnd_t                 connections_cnd;
+
+    // sets stop_requested
+    static void handle_stop_signal(int signal_number);
+    // handles all requests of one client, connection_void points to the slot in connections
+    static int handle_connection(void *connection_void);
+    // handles one request, reading everything after its empty line from request_file and answering on fd
+    // returns 1 if the connection should be closed
+    static int handle_request(FILE *request_file, int fd, const char *config_path, const char *input_path, int raw_width, int raw_height, const char *output_path);
+    // gets context for config_path from the cache, loading it if needed
+    static int acquire_context(tilize_context_t **context, const char *config_path, int *was_cached);
+    // gives back a context gotten from acquire_context()
+    static void release_context(tilize_context_t *context);
+    // writes all size bytes of data to fd
+    static int write_all(int fd, const void *data, size_t size);
+    // writes str to fd
+    static int write_str(int fd, const char *str);
+    // reads a line from file into line (without the newline), returns 1 at end of file or on error
+    static int read_line(FILE *file, char *line, size_t line_size);
+    // puts the absolute version of path into abs_path
+    static int absolute_path(char *abs_path, size_t abs_path_size, const char *path);
+
+    // listens on the unix domain socket at socket_path and handles requests until interrupted
+    int serve_run(const char *socket_path, int num_threads){
+        int retcode = 0;
+
+        // signals
+        signal(SIGPIPE, SIG_IGN);
+        struct sigaction stop_action;
+        memset(&stop_action, 0, sizeof(stop_action));
+        stop_action.sa_handler = &handle_stop_signal; // no SA_RESTART so accept() gets interrupted
+        sigemptyset(&stop_action.sa_mask);
+        sigaction(SIGINT, &stop_action, NULL);
+        sigaction(SIGTERM, &stop_action, NULL);
+
+        // state
+        stop_requested = 0;
+        atomic_store(&running, 1);
+        for(int i = 0; i < SERVE_CACHE_SIZE; ++i){
+            cache[i].config_path = NULL;
+            cache[i].context     = NULL;
+            cache[i].refs        = 0;
+        }
+        for(int i = 0; i < SERVE_MAX_CONNECTIONS; ++i){
+            connections[i] = -1;
+        }
+        num_connections = 0;
+        if(mtx_init(&cache_mtx, mtx_plain) != thrd_success){
+            VERRPRINT(0, "Failed to initialize cache_mtx");
+            return 1;
+        }
+        if(mtx_init(&connections_mtx, mtx_plain) != thrd_success){
+            VERRPRINT(0, "Failed to initialize connections_mtx");
+            mtx_destroy(&cache_mtx);
+            return 1;
+        }
+        if(cnd_init(&connections_cnd) != thrd_success){
+            VERRPRINT(0, "Failed to initialize connections_cnd");
+            mtx_destroy(&connections_mtx);
+            mtx_destroy(&cache_mtx);
+            return 1;
+        }
+        if(thread_pool_create(&pool, num_threads - 1)){
+            VERRPRINT(0, "Failed to create pool");
+            cnd_destroy(&connections_cnd);
+            mtx_destroy(&connections_mtx);
+            mtx_destroy(&cache_mtx);
+            return 1;
+        }
+
+        // create socket, replacing a stale one
+        struct sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if(strlen(socket_path) >= sizeof(address.sun_path)){
+            VERRPRINT(0, "socket_path is too long");
+            retcode = 1;
+            goto _clean_and_exit;
+        }
+        strcpy(address.sun_path, socket_path);
+        struct stat socket_stat;
+        if(!stat(socket_path, &socket_stat) && S_ISSOCK(socket_stat.st_mode)) unlink(socket_path);
+        int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(listen_fd < 0){
+            VERRPRINTF(0, "Failed to create socket (%s)", strerror(errno));
+            retcode = 1;
+            goto _clean_and_exit;
+        }
+        if(bind(listen_fd, (struct sockaddr *)&address, sizeof(address)) || listen(listen_fd, SERVE_MAX_CONNECTIONS)){
+            VERRPRINTF(0, "Failed to listen on %s (%s)", socket_path, strerror(errno));
+            close(listen_fd);
+            retcode = 1;
+            goto _clean_and_exit;
+        }
+        VPRINTF(1, "Listening on %s with %i threads, press Ctrl+C to stop\n", socket_path, thread_pool_num_threads(pool) + 1);
+
+        // accept clients
+        while(!stop_requested){
+            int fd = accept(listen_fd, NULL, NULL);
+            if(fd < 0){
+                if(errno == EINTR || errno == ECONNABORTED) continue;
+                VERRPRINTF(0, "Failed to accept connection (%s)", strerror(errno));
+                retcode = 1;
+                break;
+            }
+
+            // get a slot
+            mtx_lock(&connections_mtx);
+            int slot = -1;
+            for(int i = 0; i < SERVE_MAX_CONNECTIONS; ++i){
+                if(connections[i] == -1){
+                    slot = i;
+                    break;
+                }
+            }
+            if(slot == -1){
+                mtx_unlock(&connections_mtx);
+                write_str(fd, "error too many connections\n");
+                close(fd);
+                continue;
+            }
+            connections[slot] = fd;
+            ++num_connections;
+            mtx_unlock(&connections_mtx);
+
+            // handle it on its own thread
+            thrd_t connection_thread;
+            if(thrd_create(&connection_thread, &handle_connection, &connections[slot]) != thrd_success){
+                VERRPRINT(0, "Failed to initialize connection_thread");
+                write_str(fd, "error failed to start connection thread\n");
+                close(fd);
+                mtx_lock(&connections_mtx);
+                connections[slot] = -1;
+                --num_connections;
+                mtx_unlock(&connections_mtx);
+                continue;
+            }
+            thrd_detach(connection_thread);
+        }
+        VPRINT(1, "Stopping server\n");
+        close(listen_fd);
+        unlink(socket_path);
+
+        // cancel running requests, stop waiting for new ones and wait for all clients to be done
+        atomic_store(&running, 0);
+        mtx_lock(&connections_mtx);
+        for(int i = 0; i < SERVE_MAX_CONNECTIONS; ++i){
+            if(connections[i] != -1) shutdown(connections[i], SHUT_RD);
+        }
+        while(num_connections > 0){
+            cnd_wait(&connections_cnd, &connections_mtx);
+        }
+        mtx_unlock(&connections_mtx);
+
+        // clean and exit
+        _clean_and_exit:;
+        for(int i = 0; i < SERVE_CACHE_SIZE; ++i){
+            if(cache[i].context) tilize_context_destroy(cache[i].context);
+            if(cache[i].config_path) free(cache[i].config_path);
+        }
+        thread_pool_destroy(pool);
+        cnd_destroy(&connections_cnd);
+        mtx_destroy(&connections_mtx);
+        mtx_destroy(&cache_mtx);
+        return retcode;
+    }
+
+    // asks the server at socket_path to tilize input_path with config_path (may be NULL) into output_path and prints its answer
+    // if send_raw, input_path is decoded here and its pixels are sent instead of its path
+    int serve_client(const char *socket_path, const char *config_path, const char *input_path, const char *output_path, int send_raw){
+        char path[MAX_LINE];
+        int retcode = 0;
+        signal(SIGPIPE, SIG_IGN);
+
+        // connect
+        struct sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if(strlen(socket_path) >= sizeof(address.sun_path)){
+            VERRPRINT(0, "socket_path is too long");
+            return 1;
+        }
+        strcpy(address.sun_path, socket_path);
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(fd < 0){
+            VERRPRINTF(0, "Failed to create socket (%s)", strerror(errno));
+            return 1;
+        }
+        if(connect(fd, (struct sockaddr *)&address, sizeof(address))){
+            VERRPRINTF(0, "Failed to connect to %s (%s)", socket_path, strerror(errno));
+            close(fd);
+            return 1;
+        }
+
+        // send request
+        rgb24_texture_t input_texture = RGB24_TEXTURE_NULL;
+        if(config_path){
+            if(absolute_path(path, sizeof(path), config_path) || write_str(fd, "config ") || write_str(fd, path) || write_str(fd, "\n")){
+                VERRPRINT(0, "Failed to send config_path");
+                retcode = 1;
+                goto _clean_and_exit;
+            }
+        }
+        if(send_raw){
+            if(load_png(&input_texture, input_path)){
+                VERRPRINT(0, "Failed to load input_texture");
+                retcode = 1;
+                goto _clean_and_exit;
+            }
+            char raw_line[64];
+            sprintf(raw_line, "raw %i %i\n", input_texture.width, input_texture.height);
+            if(write_str(fd, raw_line)){
+                VERRPRINT(0, "Failed to send raw_line");
+                retcode = 1;
+                goto _clean_and_exit;
+            }
+        }
+        else if(absolute_path(path, sizeof(path), input_path) || write_str(fd, "input ") || write_str(fd, path) || write_str(fd, "\n")){
+            VERRPRINT(0, "Failed to send input_path");
+            retcode = 1;
+            goto _clean_and_exit;
+        }
+        if(absolute_path(path, sizeof(path), output_path) || write_str(fd, "output ") || write_str(fd, path) || write_str(fd, "\n\n")){
+            VERRPRINT(0, "Failed to send output_path");
+            retcode = 1;
+            goto _clean_and_exit;
+        }
+        if(send_raw){
+            unsigned char *pixels = malloc((size_t)input_texture.width * input_texture.height * 3);
+            if(!pixels){
+                VERRPRINT(0, "Failed to allocate pixels");
+                retcode = 1;
+                goto _clean_and_exit;
+            }
+            for(long i = 0; i < (long)input_texture.width * input_texture.height; ++i){
+                pixels[i * 3 + 0] = input_texture.data[i].r;
+                pixels[i * 3 + 1] = input_texture.data[i].g;
+                pixels[i * 3 + 2] = input_texture.data[i].b;
+            }
+            if(write_all(fd, pixels, (size_t)input_texture.width * input_texture.height * 3)){
+                VERRPRINT(0, "Failed to send pixels");
+                free(pixels);
+                retcode = 1;
+                goto _clean_and_exit;
+            }
+            free(pixels);
+        }
+        shutdown(fd, SHUT_WR);
+
+        // print answer
+        char answer[MAX_LINE] = "";
+        size_t answer_len = 0;
+        while(answer_len < sizeof(answer) - 1){
+            ssize_t got = read(fd, &answer[answer_len], sizeof(answer) - 1 - answer_len);
+            if(got < 0 && errno == EINTR) continue;
+            if(got <= 0) break;
+            answer_len += got;
+        }
+        answer[answer_len] = 0;
+        if(answer_len == 0){
+            VERRPRINT(0, "Server closed the connection without answering");
+            retcode = 1;
+            goto _clean_and_exit;
+        }
+        printf("%s", answer);
+        if(strncmp(answer, "ok", 2) != 0) retcode = 1;
+
+        // clean and exit
+        _clean_and_exit:;
+        rgb24_texture_destroy(&input_texture);
+        close(fd);
+        return retcode;
+    }
+
+    // sets stop_requested
+    static void handle_stop_signal(int signal_number){
+        (void)signal_number;
+        stop_requested = 1;
+    }
+    // handles all requests of one client, connection_void points to the slot in connections
+    static int handle_connection(void *connection_void){
+        int *connection = connection_void;
+        const int fd = *connection;
+        char line[MAX_LINE],
+             config_path[MAX_LINE],
+             input_path[MAX_LINE],
+             output_path[MAX_LINE];
+
+        FILE *request_file = fdopen(dup(fd), "r");
+        if(!request_file){
+            VERRPRINT(0, "Failed to open request_file");
+            write_str(fd, "error failed to read request\n");
+            goto _clean_and_exit;
+        }
+
+        // handle requests until the client is done
+        for(;;){
+            int has_config = 0,
+                raw_width  = -1,
+                raw_height = -1,
+                got_line   = 0;
+            input_path[0]  = 0;
+            output_path[0] = 0;
+            for(;;){
+                if(read_line(request_file, line, sizeof(line))){
+                    if(got_line) write_str(fd, "error unexpected end of request\n");
+                    goto _clean_and_exit;
+                }
+                if(line[0] == 0) break;
+                got_line = 1;
+                if(!strncmp(line, "config ", 7)){
+                    strcpy(config_path, &line[7]);
+                    has_config = 1;
+                }
+                else if(!strncmp(line, "input ", 6)){
+                    strcpy(input_path, &line[6]);
+                }
+                else if(!strncmp(line, "raw ", 4)){
+                    if(sscanf(&line[4], "%i %i", &raw_width, &raw_height) != 2){
+                        raw_width  = 0;
+                        raw_height = 0;
+                    }
+                }
+                else if(!strncmp(line, "output ", 7)){
+                    strcpy(output_path, &line[7]);
+                }
+                else{
+                    write_str(fd, "error unknown key\n");
+                    goto _clean_and_exit;
+                }
+            }
+            if(!got_line) continue; // stray empty line
+            if(handle_request(request_file, fd, has_config ? config_path : NULL, input_path, raw_width, raw_height, output_path)) break;
+        }
+
+        // clean and exit
+        _clean_and_exit:;
+        if(request_file) fclose(request_file);
+        close(fd);
+        mtx_lock(&connections_mtx);
+        *connection = -1;
+        --num_connections;
+        cnd_broadcast(&connections_cnd);
+        mtx_unlock(&connections_mtx);
+        return 0;
+    }
+    // handles one request, reading everything after its empty line from request_file and answering on fd
+    // returns 1 if the connection should be closed
+    static int handle_request(FILE *request_file, int fd, const char *config_path, const char *input_path, int raw_width, int raw_height, const char *output_path){
+        char answer[MAX_LINE];
+        const ms_t start_ms = current_ms();
+
+        // check request
+        if(raw_width == -1 && input_path[0] == 0){
+            write_str(fd, "error no input given\n");
+            return 0;
+        }
+        if(raw_width != -1 && (raw_width <= 0 || raw_height <= 0 || (long)raw_width * raw_height > MAX_RAW_PIXELS)){
+            write_str(fd, "error invalid raw size\n");
+            return 1; // can't know how much to skip
+        }
+        if(output_path[0] == 0){
+            write_str(fd, "error no output given\n");
+            return raw_width != -1; // raw pixels would be read as the next request
+        }
+
+        // get input
+        rgb24_texture_t input_texture = RGB24_TEXTURE_NULL;
+        if(raw_width != -1){
+            const size_t raw_size = (size_t)raw_width * raw_height * 3;
+            unsigned char *pixels = malloc(raw_size);
+            if(!pixels || rgb24_texture_create(&input_texture, raw_width, raw_height)){
+                if(pixels) free(pixels);
+                write_str(fd, "error failed to allocate input\n");
+                return 1;
+            }
+            if(fread(pixels, 1, raw_size, request_file) != raw_size){
+                free(pixels);
+                rgb24_texture_destroy(&input_texture);
+                write_str(fd, "error unexpected end of raw pixels\n");
+                return 1;
+            }
+            for(long i = 0; i < (long)raw_width * raw_height; ++i){
+                input_texture.data[i] = RGB24(pixels[i * 3 + 0], pixels[i * 3 + 1], pixels[i * 3 + 2]);
+            }
+            free(pixels);
+        }
+        else if(load_png_owned(&input_texture, input_path)){ // clients might write the file again while it's tilized
+            write_str(fd, "error failed to load input\n");
+            return 0;
+        }
+        const ms_t setup_start_ms = current_ms();
+
+        // get context
+        tilize_context_t *context;
+        int was_cached;
+        if(acquire_context(&context, config_path, &was_cached)){
+            rgb24_texture_destroy(&input_texture);
+            write_str(fd, "error failed to load configuration\n");
+            return 0;
+        }
+        const ms_t process_start_ms = current_ms();
+
+        // do the thing
+        rgb24_texture_t output_texture = RGB24_TEXTURE_NULL;
+        tilize_process_options_t options = TILIZE_PROCESS_OPTIONS_NULL;
+        options.pool    = pool;
+        options.running = &running;
+        const int ret_code = tilize_process(context, &input_texture, &output_texture, &options);
+        release_context(context);
+        rgb24_texture_destroy(&input_texture);
+        if(ret_code){
+            write_str(fd, (ret_code == 2) ? "error cancelled\n" : "error failed to tilize input\n");
+            return ret_code == 2;
+        }
+        const ms_t encode_start_ms = current_ms();
+
+        // save output
+        if(save_png(output_path, &output_texture)){
+            rgb24_texture_destroy(&output_texture);
+            write_str(fd, "error failed to save output\n");
+            return 0;
+        }
+        rgb24_texture_destroy(&output_texture);
+        const ms_t end_ms = current_ms();
+
+        // answer
+        sprintf(answer, "ok cached=%i decode_ms=%llu setup_ms=%llu process_ms=%llu encode_ms=%llu total_ms=%llu\n", was_cached,
+                (long long unsigned)(setup_start_ms - start_ms),
+                (long long unsigned)(process_start_ms - setup_start_ms),
+                (long long unsigned)(encode_start_ms - process_start_ms),
+                (long long unsigned)(end_ms - encode_start_ms),
+                (long long unsigned)(end_ms - start_ms));
+        write_str(fd, answer);
+        VPRINTF(2, "%s -> %s: %s", (raw_width != -1) ? "raw" : input_path, output_path, answer);
+        return 0;
+    }
+    // gets context for config_path from the cache, loading it if needed
+    static int acquire_context(tilize_context_t **context, const char *config_path, int *was_cached){
+        // a changed configuration is a different one, builtin ones never change
+        time_t mtime = 0;
+        if(config_path && strncmp(config_path, TILIZE_BUILTIN_PREFIX, strlen(TILIZE_BUILTIN_PREFIX))){
+            struct stat config_stat;
+            if(stat(config_path, &config_stat)){
+                VERRPRINTF(0, "Failed to stat %s", config_path);
+                return 1;
+            }
+            mtime = config_stat.st_mtime;
+        }
+
+        // look in cache
+        mtx_lock(&cache_mtx);
+        for(int i = 0; i < SERVE_CACHE_SIZE; ++i){
+            if(!cache[i].context || cache[i].mtime != mtime) continue;
+            if((config_path == NULL) != (cache[i].config_path == NULL)) continue;
+            if(config_path && strcmp(config_path, cache[i].config_path)) continue;
+            ++cache[i].refs;
+            cache[i].last_used = ++cache_clock;
+            *context = cache[i].context;
+            *was_cached = 1;
+            mtx_unlock(&cache_mtx);
+            return 0;
+        }
+        mtx_unlock(&cache_mtx);
+        *was_cached = 0;
+
+        // load it, without holding the lock so other requests don't have to wait
+        if(tilize_context_load(context, config_path)){
+            VERRPRINT(0, "Failed to load context");
+            return 1;
+        }
+        char *path_copy = NULL;
+        if(config_path){
+            path_copy = malloc(strlen(config_path) + 1);
+            if(!path_copy) return 0; // still usable, just not cached
+            strcpy(path_copy, config_path);
+        }
+
+        // put it into the least recently used slot not in use
+        mtx_lock(&cache_mtx);
+        int slot = -1;
+        for(int i = 0; i < SERVE_CACHE_SIZE; ++i){
+            if(cache[i].refs > 0) continue;
+            if(!cache[i].context){
+                slot = i;
+                break;
+            }
+            if(slot == -1 || cache[i].last_used < cache[slot].last_used) slot = i;
+        }
+        if(slot == -1){
+            // everything is in use, this one gets destroyed once it's released
+            mtx_unlock(&cache_mtx);
+            if(path_copy) free(path_copy);
+            return 0;
+        }
+        if(cache[slot].context) tilize_context_destroy(cache[slot].context);
+        if(cache[slot].config_path) free(cache[slot].config_path);
+        cache[slot].config_path = path_copy;
+        cache[slot].mtime       = mtime;
+        cache[slot].context     = *context;
+        cache[slot].refs        = 1;
+        cache[slot].last_used   = ++cache_clock;
+        mtx_unlock(&cache_mtx);
+        return 0;
+    }
+    // gives back a context gotten from acquire_context()
+    static void release_context(tilize_context_t *context){
+        mtx_lock(&cache_mtx);
+        for(int i = 0; i < SERVE_CACHE_SIZE; ++i){
+            if(cache[i].context == context){
+                --cache[i].refs;
+                mtx_unlock(&cache_mtx);
+                return;
+            }
+        }
+        mtx_unlock(&cache_mtx);
+        tilize_context_destroy(context);
+    }
+    // writes all size bytes of data to fd
+    static int write_all(int fd, const void *data, size_t size){
+        const char *bytes = data;
+        while(size > 0){
+            ssize_t written = write(fd, bytes, size);
+            if(written < 0 && errno == EINTR) continue;
+            if(written <= 0) return 1;
+            bytes += written;
+            size  -= written;
+        }
+        return 0;
+    }
+    // writes str to fd
+    static int write_str(int fd, const char *str){
+        return write_all(fd, str, strlen(str));
+    }
+    // reads a line from file into line (without the newline), returns 1 at end of file or on error
+    static int read_line(FILE *file, char *line, size_t line_size){
+        if(!fgets(line, line_size, file)) return 1;
+        size_t len = strlen(line);
+        if(len > 0 && line[len - 1] == '\n') line[--len] = 0;
+        if(len > 0 && line[len - 1] == '\r') line[--len] = 0;
+        return 0;
+    }
+    // puts the absolute version of path into abs_path
+    static int absolute_path(char *abs_path, size_t abs_path_size, const char *path){
+        if(path[0] == '/'){
+            if(strlen(path) >= abs_path_size) return 1;
+            strcpy(abs_path, path);
+            return 0;
+        }
+        if(!getcwd(abs_path, abs_path_size)) return 1;
+        if(strlen(abs_path) + 1 + strlen(path) >= abs_path_size) return 1;
+        strcat(abs_path, "/");
+        strcat(abs_path, path);
+        return 0;
+    }
+#else
+    #include <stdio.h>
+
+    // dummy implementation to give warnings
+    int serve_run(const char *socket_path, int num_threads){
+        fprintf(stderr, "Warning: serve_run() not supported at compiletime\n");
+        int a = socket_path[0] + num_threads; a = a + a; // to keep out some warnings
+        return 1;
+    }
+    int serve_client(const char *socket_path, const char *config_path, const char *input_path, const char *output_path, int send_raw){
+        fprintf(stderr, "Warning: serve_client() not supported at compiletime\n");
+        int a = socket_path[0] + (config_path != NULL) + input_path[0] + output_path[0] + send_raw; a = a + a; // to keep out some warnings
+        return 1;
+    }
+#endif
@@ -0,0 +1,71 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#ifndef SERVE_H__
+#define SERVE_H__
+
+#ifndef SERVE_SUPPORTED
+    #if defined(__unix__)
+        #define SERVE_SUPPORTED 1
+    #else
+        #define SERVE_SUPPORTED 0
+    #endif
+#endif
+
+// maximum amount of configurations kept loaded at once
+#ifndef SERVE_CACHE_SIZE
+    #define SERVE_CACHE_SIZE 8
+#endif
+// maximum amount of clients connected at once
+#ifndef SERVE_MAX_CONNECTIONS
+    #define SERVE_MAX_CONNECTIONS 64
+#endif
+
+// protocol:
+// a client sends any amount of requests over one connection, each a list of `key value` lines ended by an empty line:
+//  config [path]              | configuration to use, the default one if left out
+//  input [path]               | image to tilize
+//  raw [width] [height]       | instead of input, width * height rgb pixels (3 bytes each) follow right after the empty line
+//  output [path]              | where to save the result
+// the server answers every request with a single line, either
+//  ok cached=[0/1] decode_ms=[ms] setup_ms=[ms] process_ms=[ms] encode_ms=[ms] total_ms=[ms]
+//  error [message]
+// relative paths are relative to the working directory of the server
+
+// listens on the unix domain socket at socket_path and handles requests until interrupted
+int serve_run(const char *socket_path, int num_threads);
+// asks the server at socket_path to tilize input_path with config_path (may be NULL) into output_path and prints its answer
+// if send_raw, input_path is decoded here and its pixels are sent instead of its path
+int serve_client(const char *socket_path, const char *config_path, const char *input_path, const char *output_path, int send_raw);
+
+#endif
@@ -0,0 +1,101 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#include "shard.h"
+
+#include <stdlib.h>
+#include "load_png.h"
+#include "print.h"
+#include "texture.h"
+
+// marks every row of tile_map outside of shard shard_index of shard_count as TILIZE_TILE_SKIP
+// shard i gets the rows from i * tile_amount_y / shard_count up to (i + 1) * tile_amount_y / shard_count
+void shard_restrict(tilize_tile_map_t *tile_map, int shard_index, int shard_count){
+    const int row_min = (int)((long long)shard_index * tile_map->tile_amount_y / shard_count),
+              row_max = (int)((long long)(shard_index + 1) * tile_map->tile_amount_y / shard_count);
+    for(int y = 0; y < tile_map->tile_amount_y; ++y){
+        if(y >= row_min && y < row_max) continue;
+        for(int x = 0; x < tile_map->tile_amount_x; ++x) tile_map->tiles[y * tile_map->tile_amount_x + x].pattern = TILIZE_TILE_SKIP;
+    }
+}
+// merges the num_maps tile maps at map_paths, made with the configuration at config_path (the default one if NULL) for the same image
+// and saves the image they make up to output_path, tiles no map has are left black
+int shard_merge(const char *const *map_paths, int num_maps, const char *config_path, const char *output_path){
+    int                ret_code       = 1;
+    tilize_context_t  *context        = NULL;
+    tilize_tile_map_t  merged         = TILIZE_TILE_MAP_NULL,
+                       shard          = TILIZE_TILE_MAP_NULL;
+    rgb24_texture_t    output_texture = RGB24_TEXTURE_NULL;
+
+    if(tilize_context_load(&context, config_path)){
+        VERRPRINT(0, "Failed to load context");
+        goto _clean_and_exit;
+    }
+    if(tilize_tile_map_load(&merged, map_paths[0])){
+        VERRPRINTF(0, "Failed to load %s", map_paths[0]);
+        goto _clean_and_exit;
+    }
+    for(int i = 1; i < num_maps; ++i){
+        if(tilize_tile_map_load(&shard, map_paths[i])){
+            VERRPRINTF(0, "Failed to load %s", map_paths[i]);
+            goto _clean_and_exit;
+        }
+        if(tilize_tile_map_merge(&merged, &shard)){
+            VERRPRINTF(0, "Failed to merge %s into %s", map_paths[i], map_paths[0]);
+            goto _clean_and_exit;
+        }
+        tilize_tile_map_destroy(&shard);
+    }
+
+    // warn about holes
+    int num_missing = 0;
+    for(int i = 0; i < merged.tile_amount_x * merged.tile_amount_y; ++i) num_missing += merged.tiles[i].pattern < 0;
+    if(num_missing) VPRINTF(1, "Warning: %i of %i tiles are in none of the given tile maps and are left black\n", num_missing, merged.tile_amount_x * merged.tile_amount_y);
+
+    if(tilize_tile_map_render(context, &merged, &output_texture)){
+        VERRPRINT(0, "Failed to render merged tile map, was it made with a different configuration?");
+        goto _clean_and_exit;
+    }
+    if(save_png(output_path, &output_texture)){
+        VERRPRINTF(0, "Failed to save output_texture to %s", output_path);
+        goto _clean_and_exit;
+    }
+    ret_code = 0;
+
+_clean_and_exit:
+    rgb24_texture_destroy(&output_texture);
+    tilize_tile_map_destroy(&shard);
+    tilize_tile_map_destroy(&merged);
+    tilize_context_destroy(context);
+    return ret_code;
+}
@@ -0,0 +1,225 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#include "sweep.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "atlas.h"
+#include "load_png.h"
+#include "print.h"
+#include "texture.h"
+#include "thread_pool.h"
+#include "tilize.h"
+#include "timing.h"
+
+// a configuration being swept over
+struct sweep_config{
+    const char       *path,
+                     *name;        // points into path
+    int               name_length;
+    char             *output_path;
+    tilize_context_t *context;
+    int               split;       // index of the tiles input is split into for this configuration
+    ms_t              load_ms;
+};
+
+// puts the name of the configuration at config_path (without directories, extension or TILIZE_BUILTIN_PREFIX) into name and name_length
+static void get_config_name(const char *config_path, const char **name, int *name_length);
+// creates the path output_template with every `%s` replaced by the name_length bytes at name, returns NULL on failure
+static char *get_output_path(const char *output_template, const char *name, int name_length);
+
+// tilizes the image at input_path with each of the num_configs configurations at config_paths, decoding it only once
+// configurations with the same tile size share the tiles it is split into, and all of them run on the same threads one after another
+// results are saved to output_template with every `%s` in it replaced by the name of the configuration (its file name without extension)
+// how long each configuration took is printed, num_threads, deadline_ms, quality and file_outp_format of flag_config are used for all of them
+// unless ask is 0, the user is asked before any existing file is overwritten
+int sweep_run(const char *input_path, const char *const *config_paths, int num_configs, const char *output_template, const flag_config_t *flag_config, int ask){
+    int                  ret_code      = 1,
+                         num_splits    = 0;
+    rgb24_texture_t      input_texture = RGB24_TEXTURE_NULL;
+    thread_pool_t       *pool          = NULL;
+    struct sweep_config *configs       = calloc(num_configs, sizeof(*configs));
+    planar_atlas_t      *splits        = malloc(num_configs * sizeof(*splits)); // at most one per configuration
+    if(!configs || !splits){
+        VERRPRINT(0, "Failed to allocate configs or splits");
+        goto _clean_and_exit;
+    }
+
+    // name every result, and ask before overwriting any of them
+    for(int i = 0; i < num_configs; ++i){
+        struct sweep_config *config = &configs[i];
+        config->path = config_paths[i];
+        get_config_name(config->path, &config->name, &config->name_length);
+        config->output_path = get_output_path(output_template, config->name, config->name_length);
+        if(!config->output_path){
+            VERRPRINT(0, "Failed to create output_path");
+            goto _clean_and_exit;
+        }
+        if(!ask) continue;
+        FILE *output_test = fopen(config->output_path, "r");
+        if(!output_test) continue;
+        fclose(output_test);
+        if(!strcmp(input_path, "-")){
+            VPRINTF(1, "%s already exists and stdin is taken by the input image, please add `-y` to overwrite it\n", config->output_path);
+            goto _clean_and_exit;
+        }
+        printf("Warning: %s already exists. Overwrite (y / N)?\n", config->output_path);
+        char yN = getchar();
+        if(!(yN == 'y' || yN == 'Y')){
+            VPRINTF(1, "Not overwriting %s, exiting\n", config->output_path);
+            ret_code = 0;
+            goto _clean_and_exit;
+        }
+        while(getchar() != '\n');
+    }
+
+    // decode input once
+    ms_t start_ms = current_ms();
+    if(load_png(&input_texture, input_path)){
+        VERRPRINTF(0, "Failed to load %s", input_path);
+        goto _clean_and_exit;
+    }
+    VPRINTF(2, "Loaded %s in %llu ms\n", input_path, (long long unsigned)(current_ms() - start_ms));
+
+    // load every configuration, splitting input for every tile size not seen yet
+    for(int i = 0; i < num_configs; ++i){
+        struct sweep_config *config = &configs[i];
+        start_ms = current_ms();
+        if(tilize_context_load(&config->context, config->path)){
+            VERRPRINTF(0, "Failed to load configuration %s", config->path);
+            config->context = NULL;
+            goto _clean_and_exit;
+        }
+        config->load_ms = current_ms() - start_ms;
+
+        int tile_width,
+            tile_height;
+        tilize_context_tile_size(config->context, &tile_width, &tile_height);
+        for(config->split = 0; config->split < num_splits; ++config->split){
+            if(splits[config->split].tile_width == tile_width && splits[config->split].tile_height == tile_height) break;
+        }
+        if(config->split == num_splits){
+            splits[num_splits] = PLANAR_ATLAS_NULL;
+            if(planar_atlas_from_texture(&splits[num_splits], &input_texture, tile_width, tile_height)){
+                VERRPRINTF(0, "Failed to split %s into %ix%i tiles", input_path, tile_width, tile_height);
+                goto _clean_and_exit;
+            }
+            ++num_splits;
+        }
+    }
+    VPRINTF(2, "Split %s for %i tile sizes\n", input_path, num_splits);
+
+    // one pool for all configurations
+    if(flag_config->num_threads > 1 && thread_pool_create(&pool, flag_config->num_threads - 1)){
+        VERRPRINT(0, "Failed to create pool");
+        goto _clean_and_exit;
+    }
+
+    // tilize with each, one after another
+    int failed = 0;
+    for(int i = 0; i < num_configs; ++i){
+        const struct sweep_config *config      = &configs[i];
+        const char                *output_path = config->output_path;
+        start_ms = current_ms();
+        tilize_process_options_t options = TILIZE_PROCESS_OPTIONS_NULL;
+        options.num_threads = flag_config->num_threads;
+        options.pool        = pool;
+        options.deadline_ms = flag_config->deadline_ms;
+        options.quality     = flag_config->quality;
+        options.input_tiles = &splits[config->split];
+        rgb24_texture_t output_texture = RGB24_TEXTURE_NULL;
+        if(tilize_process(config->context, &input_texture, &output_texture, &options)){
+            VERRPRINTF(0, "Failed to tilize %s with %s", input_path, config->path);
+            failed = 1;
+            continue;
+        }
+        const ms_t process_ms = current_ms() - start_ms;
+        if(save_png_as(output_path, flag_config->file_outp_format, &output_texture)){
+            VERRPRINTF(0, "Failed to save %s", output_path);
+            failed = 1;
+        }
+        else VPRINTF(1, "%.*s: tilized in %llu ms (configuration loaded in %llu ms) into %s\n", config->name_length, config->name,
+                     (long long unsigned)process_ms, (long long unsigned)config->load_ms, output_path);
+        rgb24_texture_destroy(&output_texture);
+    }
+    ret_code = failed;
+
+_clean_and_exit:
+    thread_pool_destroy(pool);
+    for(int i = 0; i < num_splits; ++i) planar_atlas_destroy(&splits[i]);
+    if(configs){
+        for(int i = 0; i < num_configs; ++i){
+            tilize_context_destroy(configs[i].context);
+            free(configs[i].output_path);
+        }
+    }
+    free(splits);
+    free(configs);
+    rgb24_texture_destroy(&input_texture);
+    return ret_code;
+}
+
+// puts the name of the configuration at config_path (without directories, extension or TILIZE_BUILTIN_PREFIX) into name and name_length
+static void get_config_name(const char *config_path, const char **name, int *name_length){
+    if(!strncmp(config_path, TILIZE_BUILTIN_PREFIX, strlen(TILIZE_BUILTIN_PREFIX))){
+        *name        = config_path + strlen(TILIZE_BUILTIN_PREFIX);
+        *name_length = (int)strlen(*name);
+        return;
+    }
+    *name = config_path;
+    for(const char *c = config_path; *c; ++c){
+        if(*c == '/' || *c == '\\') *name = c + 1;
+    }
+    const char *extension = strrchr(*name, '.');
+    *name_length = extension && extension != *name ? (int)(extension - *name) : (int)strlen(*name);
+}
+// creates the path output_template with every `%s` replaced by the name_length bytes at name, returns NULL on failure
+static char *get_output_path(const char *output_template, const char *name, int name_length){
+    size_t length = strlen(output_template) + 1;
+    for(const char *c = strstr(output_template, "%s"); c; c = strstr(c + 2, "%s")) length += name_length;
+    char *path = malloc(length);
+    if(!path) return NULL;
+    char *end = path;
+    for(const char *c = output_template; *c;){
+        if(c[0] == '%' && c[1] == 's'){
+            memcpy(end, name, name_length);
+            end += name_length;
+            c   += 2;
+        }
+        else *end++ = *c++;
+    }
+    *end = '\0';
+    return path;
+}
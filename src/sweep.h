@@ -0,0 +1,46 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#ifndef SWEEP_H__
+#define SWEEP_H__
+
+#include "configuration.h"
+
+// tilizes the image at input_path with each of the num_configs configurations at config_paths, decoding it only once
+// configurations with the same tile size share the tiles it is split into, and all of them run on the same threads one after another
+// results are saved to output_template with every `%s` in it replaced by the name of the configuration (its file name without extension)
+// how long each configuration took is printed, num_threads, deadline_ms, quality and file_outp_format of flag_config are used for all of them
+// unless ask is 0, the user is asked before any existing file is overwritten
+int sweep_run(const char *input_path, const char *const *config_paths, int num_configs, const char *output_template, const flag_config_t *flag_config, int ask);
+
+#endif
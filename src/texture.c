@@ -40,6 +40,7 @@
 int rgb24_texture_create(rgb24_texture_t *texture, int width, int height){
     texture->width = width;
     texture->height = height;
+    texture->mapping = MAPPED_FILE_NULL;
     texture->data = malloc(width * height * sizeof(*texture->data));
     if(!texture->data){
         VERRPRINT(0, "Failed to allocate texture->data");
@@ -51,7 +52,11 @@ int rgb24_texture_create(rgb24_texture_t *texture, int width, int height){
 void rgb24_texture_destroy(rgb24_texture_t *texture){
     texture->width = 0;
     texture->height = 0;
-    if(texture->data){
+    if(texture->mapping.data){
+        unmap_file(&texture->mapping);
+        texture->data = NULL;
+    }
+    else if(texture->data){
         free(texture->data);
         texture->data = NULL;
     }
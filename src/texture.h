@@ -34,16 +34,18 @@
 #ifndef TEXTURE_H__
 #define TEXTURE_H__
 
+#include "map_file.h"
 #include "rgb24.h"
 
 // a texture composed of rgb24s
 typedef struct rgb24_texture_t{
-    int      width, 
-             height;
-    rgb24_t *data;
+    int           width, 
+                  height;
+    rgb24_t      *data;
+    mapped_file_t mapping; // if not empty, data points into this file (and mustn't be written to) instead of being allocated
 } rgb24_texture_t;
 
-#define RGB24_TEXTURE_NULL ((rgb24_texture_t){0, 0, NULL})
+#define RGB24_TEXTURE_NULL ((rgb24_texture_t){0, 0, NULL, MAPPED_FILE_NULL})
 
 // creates a new texture
 int rgb24_texture_create(rgb24_texture_t *texture, int width, int height);
@@ -0,0 +1,272 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#include "thread_pool.h"
+
+#include <stdlib.h>
+#include "print.h"
+#include "tinycthread.h"
+
+// one call to thread_pool_run() or thread_pool_start()
+struct thread_pool_batch{
+    thread_pool_func_t        func;
+    char                     *data;
+    size_t                    element_size;
+    int                       num_elements,
+                              next_element, // first element not yet claimed by any thread
+                              remaining,    // elements not yet finished
+                              ret_code;
+    struct thread_pool_batch *next_batch;
+};
+
+// a set of threads that stay around waiting for work
+struct thread_pool_t{
+    int                       num_threads;
+    thrd_t                   *threads;
+    mtx_t                     mtx;
+    cnd_t                     work_cnd,     // signaled when a batch is added or the pool is stopping
+                              done_cnd;     // signaled when a batch is finished
+    struct thread_pool_batch *batches;      // batches with unclaimed elements, oldest first
+    int                       stopping;
+};
+
+// what every thread of a pool runs
+static int pool_worker(void *pool_void);
+// fills batch with everything needed to run func on each element of data
+static void init_batch(struct thread_pool_batch *batch, thread_pool_func_t func, void *data, size_t element_size, int num_elements);
+// queues batch in pool, pool->mtx has to be unlocked
+static void queue_batch(thread_pool_t *pool, struct thread_pool_batch *batch);
+// helps out with batch until everything is claimed, then waits for the rest to finish
+// pool->mtx has to be locked
+static void finish_batch(thread_pool_t *pool, struct thread_pool_batch *batch);
+// claims the next element of batch, removing batch from the queue if it was the last one
+// pool->mtx has to be locked
+static int claim_element(thread_pool_t *pool, struct thread_pool_batch *batch);
+// runs element index of batch and reports it as finished
+// pool->mtx has to be locked, it is unlocked while running
+static void run_element(thread_pool_t *pool, struct thread_pool_batch *batch, int index);
+
+// creates a pool of num_threads threads
+int thread_pool_create(thread_pool_t **pool, int num_threads){
+    thread_pool_t *p = malloc(sizeof(*p));
+    if(!p){
+        VERRPRINT(0, "Failed to allocate p");
+        return 1;
+    }
+    p->num_threads = 0;
+    p->batches     = NULL;
+    p->stopping    = 0;
+    if(num_threads < 0) num_threads = 0;
+    p->threads = malloc((num_threads + 1) * sizeof(*p->threads));
+    if(!p->threads){
+        VERRPRINT(0, "Failed to allocate p->threads");
+        free(p);
+        return 1;
+    }
+    if(mtx_init(&p->mtx, mtx_plain) != thrd_success){
+        VERRPRINT(0, "Failed to initialize p->mtx");
+        free(p->threads);
+        free(p);
+        return 1;
+    }
+    if(cnd_init(&p->work_cnd) != thrd_success){
+        VERRPRINT(0, "Failed to initialize p->work_cnd");
+        mtx_destroy(&p->mtx);
+        free(p->threads);
+        free(p);
+        return 1;
+    }
+    if(cnd_init(&p->done_cnd) != thrd_success){
+        VERRPRINT(0, "Failed to initialize p->done_cnd");
+        cnd_destroy(&p->work_cnd);
+        mtx_destroy(&p->mtx);
+        free(p->threads);
+        free(p);
+        return 1;
+    }
+
+    // start threads
+    for(int i = 0; i < num_threads; ++i){
+        if(thrd_create(&p->threads[i], &pool_worker, p) != thrd_success){
+            VERRPRINTF(0, "Failed to initialize p->threads[%i]", i);
+            thread_pool_destroy(p);
+            return 1;
+        }
+        ++p->num_threads;
+    }
+
+    *pool = p;
+    return 0;
+}
+// waits for the threads of pool to finish their current work and destroyes pool
+void thread_pool_destroy(thread_pool_t *pool){
+    if(!pool) return;
+    mtx_lock(&pool->mtx);
+    pool->stopping = 1;
+    cnd_broadcast(&pool->work_cnd);
+    mtx_unlock(&pool->mtx);
+    for(int i = 0; i < pool->num_threads; ++i){
+        thrd_join(pool->threads[i], NULL);
+    }
+    cnd_destroy(&pool->done_cnd);
+    cnd_destroy(&pool->work_cnd);
+    mtx_destroy(&pool->mtx);
+    free(pool->threads);
+    free(pool);
+}
+
+// gets the amount of threads in pool, 0 if pool is NULL
+int thread_pool_num_threads(const thread_pool_t *pool){
+    return pool ? pool->num_threads : 0;
+}
+
+// runs func on each of the num_elements elements (element_size bytes each) of data using pool, the calling thread helps out
+// if pool is NULL, everything is run on the calling thread
+// returns the return codes of all calls to func or-ed together
+int thread_pool_run(thread_pool_t *pool, thread_pool_func_t func, void *data, size_t element_size, int num_elements){
+    if(num_elements <= 0) return 0;
+
+    // no pool, do it all here
+    if(!pool){
+        int ret_code = 0;
+        for(int i = 0; i < num_elements; ++i){
+            ret_code |= func((char *)data + i * element_size);
+        }
+        return ret_code;
+    }
+
+    // queue batch and help out
+    struct thread_pool_batch batch;
+    init_batch(&batch, func, data, element_size, num_elements);
+    queue_batch(pool, &batch);
+    mtx_lock(&pool->mtx);
+    finish_batch(pool, &batch);
+    mtx_unlock(&pool->mtx);
+    return batch.ret_code;
+}
+// starts running func on each element of data like thread_pool_run(), but returns right away so the calling thread can do something else
+// data has to stay around until thread_pool_wait() is called on batch, which has to happen exactly once
+// elements no thread of pool got to yet (all of them if pool has no threads or is NULL) are run by thread_pool_wait()
+int thread_pool_start(thread_pool_t *pool, thread_pool_batch_t **batch, thread_pool_func_t func, void *data, size_t element_size, int num_elements){
+    struct thread_pool_batch *b = malloc(sizeof(*b));
+    if(!b){
+        VERRPRINT(0, "Failed to allocate b");
+        return 1;
+    }
+    init_batch(b, func, data, element_size, num_elements);
+    if(pool && num_elements > 0) queue_batch(pool, b); // otherwise thread_pool_wait() does it all
+    *batch = b;
+    return 0;
+}
+// waits for batch to finish, helping out with its remaining elements, and frees it
+// returns the return codes of all calls to func or-ed together
+int thread_pool_wait(thread_pool_t *pool, thread_pool_batch_t *batch){
+    int ret_code;
+    if(pool && batch->num_elements > 0){
+        mtx_lock(&pool->mtx);
+        finish_batch(pool, batch);
+        mtx_unlock(&pool->mtx);
+        ret_code = batch->ret_code;
+    }
+    else{
+        ret_code = thread_pool_run(NULL, batch->func, batch->data, batch->element_size, batch->num_elements);
+    }
+    free(batch);
+    return ret_code;
+}
+
+// what every thread of a pool runs
+static int pool_worker(void *pool_void){
+    thread_pool_t *pool = pool_void;
+    mtx_lock(&pool->mtx);
+    for(;;){
+        while(!pool->batches && !pool->stopping){
+            cnd_wait(&pool->work_cnd, &pool->mtx);
+        }
+        if(!pool->batches) break; // stopping and nothing left to do
+        struct thread_pool_batch *batch = pool->batches;
+        run_element(pool, batch, claim_element(pool, batch));
+    }
+    mtx_unlock(&pool->mtx);
+    return 0;
+}
+// fills batch with everything needed to run func on each element of data
+static void init_batch(struct thread_pool_batch *batch, thread_pool_func_t func, void *data, size_t element_size, int num_elements){
+    batch->func         = func;
+    batch->data         = data;
+    batch->element_size = element_size;
+    batch->num_elements = num_elements;
+    batch->next_element = 0;
+    batch->remaining    = num_elements;
+    batch->ret_code     = 0;
+    batch->next_batch   = NULL;
+}
+// queues batch in pool, pool->mtx has to be unlocked
+static void queue_batch(thread_pool_t *pool, struct thread_pool_batch *batch){
+    mtx_lock(&pool->mtx);
+    struct thread_pool_batch **last = &pool->batches;
+    while(*last) last = &(*last)->next_batch;
+    *last = batch;
+    cnd_broadcast(&pool->work_cnd);
+    mtx_unlock(&pool->mtx);
+}
+// helps out with batch until everything is claimed, then waits for the rest to finish
+// pool->mtx has to be locked
+static void finish_batch(thread_pool_t *pool, struct thread_pool_batch *batch){
+    while(batch->next_element < batch->num_elements){
+        run_element(pool, batch, claim_element(pool, batch));
+    }
+    while(batch->remaining > 0){
+        cnd_wait(&pool->done_cnd, &pool->mtx);
+    }
+}
+// claims the next element of batch, removing batch from the queue if it was the last one
+// pool->mtx has to be locked
+static int claim_element(thread_pool_t *pool, struct thread_pool_batch *batch){
+    const int index = batch->next_element++;
+    if(batch->next_element >= batch->num_elements){
+        struct thread_pool_batch **current = &pool->batches;
+        while(*current && *current != batch) current = &(*current)->next_batch;
+        if(*current) *current = batch->next_batch;
+    }
+    return index;
+}
+// runs element index of batch and reports it as finished
+// pool->mtx has to be locked, it is unlocked while running
+static void run_element(thread_pool_t *pool, struct thread_pool_batch *batch, int index){
+    mtx_unlock(&pool->mtx);
+    const int ret_code = batch->func(batch->data + index * batch->element_size);
+    mtx_lock(&pool->mtx);
+    batch->ret_code |= ret_code;
+    if(--batch->remaining == 0) cnd_broadcast(&pool->done_cnd);
+}
@@ -0,0 +1,69 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#ifndef THREAD_POOL_H__
+#define THREAD_POOL_H__
+
+#include <stddef.h>
+
+// a set of threads that stay around waiting for work
+// can be shared by any amount of threads handing it work at the same time
+typedef struct thread_pool_t thread_pool_t;
+
+// gets run by the pool on one element of the data passed to thread_pool_run()
+typedef int (*thread_pool_func_t)(void *element);
+
+// work started with thread_pool_start() that wasn't waited for yet
+typedef struct thread_pool_batch thread_pool_batch_t;
+
+// creates a pool of num_threads threads
+int thread_pool_create(thread_pool_t **pool, int num_threads);
+// waits for the threads of pool to finish their current work and destroyes pool
+void thread_pool_destroy(thread_pool_t *pool);
+
+// gets the amount of threads in pool, 0 if pool is NULL
+int thread_pool_num_threads(const thread_pool_t *pool);
+
+// runs func on each of the num_elements elements (element_size bytes each) of data using pool, the calling thread helps out
+// if pool is NULL, everything is run on the calling thread
+// returns the return codes of all calls to func or-ed together
+int thread_pool_run(thread_pool_t *pool, thread_pool_func_t func, void *data, size_t element_size, int num_elements);
+// starts running func on each element of data like thread_pool_run(), but returns right away so the calling thread can do something else
+// data has to stay around until thread_pool_wait() is called on batch, which has to happen exactly once
+// elements no thread of pool got to yet (all of them if pool has no threads or is NULL) are run by thread_pool_wait()
+int thread_pool_start(thread_pool_t *pool, thread_pool_batch_t **batch, thread_pool_func_t func, void *data, size_t element_size, int num_elements);
+// waits for batch to finish, helping out with its remaining elements, and frees it
+// returns the return codes of all calls to func or-ed together
+int thread_pool_wait(thread_pool_t *pool, thread_pool_batch_t *batch);
+
+#endif
@@ -0,0 +1,1273 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define _XOPEN_SOURCE 700 // realpath()
+#endif
+#include "tilize.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#if defined(_WIN32)
+    #include <process.h>
+    #define getpid _getpid
+#elif defined(__unix__) || defined(__APPLE__)
+    #include <unistd.h>
+#else
+    #define getpid() 0
+#endif
+#include "atlas.h"
+#include "configuration.h"
+#include "load_png.h"
+#include "map_file.h"
+#include "print.h"
+#include "search.h"
+#include "texture.h"
+#include "thread_pool.h"
+#include "timing.h"
+
+// everything needed to tilize images with one configuration
+struct tilize_context_t{
+    int                  num_colors;
+    rgb24_t             *colors;
+    int                  tile_width,
+                         tile_height,
+                         num_patterns;
+    const unsigned char *masks;       // tile_width * tile_height bytes per pattern, 1 where col1 is used and 0 where col2 is
+    unsigned char       *owned_masks; // masks if they were allocated for this context, NULL if they point into compiled
+    mapped_file_t        compiled;    // compiled configuration this context was loaded from, if any
+    search_t            *search;
+    _Atomic(search_t *)  coarse;      // search over a few patterns for the first pass of tilize_process() with a deadline, NULL until the first one (see get_coarse())
+    int                  col1_min,
+                         col1_max,
+                         col2_min,
+                         col2_max;
+};
+
+// compiled configurations:
+// a compiled_header, followed by
+//  config_path_length bytes of the absolute path to the json configuration (including '\0')
+//  pattern_path_length bytes of the absolute path to the pattern image (including '\0', 0 bytes if the default pattern is used)
+//  num_colors colors as 3 bytes each (r, g, b)
+//  num_patterns masks as tile_width * tile_height bytes each (see tilize_context_t.masks)
+// everything is in the byte order and layout of the machine that compiled it, anything else fails the magic check
+#define COMPILED_MAGIC   0x7a6c7454u // "Ttlz" on little endian machines
+#define COMPILED_VERSION 2u
+struct compiled_header{
+    uint32_t magic,
+             version,
+             checksum,            // fnv-1a over everything after the header
+             tile_width,
+             tile_height,
+             num_patterns,
+             num_colors,
+             config_path_length,
+             pattern_path_length;
+    int32_t  bckg_color,
+             forg_color,
+             reserved;
+    uint64_t config_mtime,        // modification times and sizes of the sources when compiled, to know when to recompile
+             config_size,
+             pattern_mtime,
+             pattern_size;
+};
+
+// tile maps:
+// a tile_map_header, followed by tile_amount_x * tile_amount_y tilize_tile_ts
+// in the byte order of the machine that saved it, like compiled configurations
+#define TILE_MAP_MAGIC   0x6d6c7454u // "Ttlm" on little endian machines
+#define TILE_MAP_VERSION 1u
+struct tile_map_header{
+    uint32_t magic,
+             version,
+             checksum,      // fnv-1a over the tiles
+             image_width,
+             image_height,
+             tile_width,
+             tile_height,
+             tile_amount_x,
+             tile_amount_y,
+             config_hash,
+             input_hash,
+             reserved;
+};
+
+// start of every fnv-1a hash
+#define FNV1A_BASIS 2166136261u
+
+// builtin configurations available to tilize_context_load()
+static const tilize_builtin_t *builtins;
+static int                     num_builtins;
+
+// parts each thread gets to work on, more than one so threads finishing early can help out the others
+#define PARTS_PER_THREAD 4
+// tiles searched at once, between which processing can be cancelled
+#define PROCESS_CHUNK_TILES 64
+// patterns the first pass of tilize_process() with a deadline tries
+#define PROGRESSIVE_PATTERNS 16
+// tiles searched exactly to measure how much worse results are with tilize_process_options_t.quality
+#define QUALITY_SAMPLE_TILES 256
+
+// all data needed to run one part of tilize_process()
+struct process_thread_data{
+    int ct_min, ct_max; // minimum and maximum (exclusive) tile indecies computed in this part
+    const tilize_context_t         *context;
+    const planar_atlas_t           *input_tiles;
+    rgb24_atlas_t                  *output_atlas;
+    const tilize_process_options_t *options;
+    const search_t                 *search;
+    search_result_t                *tile_results; // if not NULL, the result of every tile gets saved here
+    const int                      *tile_order;   // if not NULL, tiles are taken in this order through next_tile instead of from ct_min on
+    atomic_int                     *next_tile;
+    ms_t                            deadline;     // with tile_order, no more tiles are taken once this time has passed
+    tilize_tile_map_t              *tile_map;     // if not NULL, results are put into it (under options->tile_map_mtx) as soon as a chunk is done
+};
+// a tile and how far its current result is from it, for refining the worst ones first
+struct tile_priority{
+    unsigned long difference;
+    int           tile;
+};
+
+// performs the loop that does the thing
+static int process_loop(void *input_data_void);
+// compares two tile_prioritys, those with a higher difference first
+static int compare_priorities(const void *a, const void *b);
+// searches a sample of the num_todo tiles todo (or the first num_todo if it's NULL) of input_tiles exactly and prints how much worse tile_results are, which were found with quality
+static int report_quality(const tilize_context_t *context, const planar_atlas_t *input_tiles, const search_result_t *tile_results, const int *todo, int num_todo, int quality);
+// checks whether tile_map can be drawn with context, returns 1 if not
+static int check_tile_map(const tilize_context_t *context, const tilize_tile_map_t *tile_map);
+// draws every tile of tile_map into output_atlas, made for it
+// options may be NULL, otherwise tiles are handed to options->tile_callback
+static int draw_tile_map(const tilize_context_t *context, const tilize_tile_map_t *tile_map, rgb24_atlas_t *output_atlas, const tilize_process_options_t *options);
+// draws tile as tile tile_i of output_atlas, using tile_texture of the tile size of context
+// TILIZE_TILE_TODO and TILIZE_TILE_SKIP tiles are drawn black, others are handed to options->tile_callback if options isn't NULL
+static void draw_tile(const tilize_context_t *context, rgb24_atlas_t *output_atlas, const tilize_process_options_t *options, rgb24_texture_t *tile_texture, int tile_i, const tilize_tile_t *tile);
+// creates the search of ctx once everything else about it is known, destroying ctx on failure
+static int create_search(tilize_context_t *ctx);
+// gets the search over a few patterns of context for the first pass of tilize_process() with a deadline into coarse, creating it the first time it's needed
+// coarse is NULL if context doesn't have enough different patterns for it to be any faster
+static int get_coarse(const tilize_context_t *context, search_t **coarse);
+// puts the path of the pattern image of tilize_config loaded from config_path into pattern_path
+static void get_pattern_path(char *restrict pattern_path, size_t pattern_path_size, const tilize_config_t *restrict tilize_config, const char *restrict config_path);
+// gets the absolute path of the existing file at path into absolute, so it can be found from any working directory
+static int get_absolute_path(char *restrict absolute, size_t absolute_size, const char *restrict path);
+// gets the modification time and size of the file at path, returns 1 if it doesn't exist
+static int get_file_stamp(const char *restrict path, uint64_t *restrict mtime, uint64_t *restrict size);
+// continues the fnv-1a hash hash (FNV1A_BASIS to start a new one) with size bytes at data
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t size);
+// returns whether compiled starts like a compiled configuration
+static int is_compiled(const mapped_file_t *compiled);
+// returns whether compiled, which starts like a compiled configuration, is a complete and undamaged one
+static int compiled_valid(const mapped_file_t *compiled);
+// returns whether the sources of compiled changed since it was compiled
+static int compiled_stale(const mapped_file_t *compiled);
+// creates a context from the valid compiled configuration in compiled, which context takes ownership of
+static int context_from_compiled(tilize_context_t **context, mapped_file_t *compiled);
+
+// creates a context from tilize_config
+// config_path is where tilize_config was loaded from, pattern_path is relative to it; if either is NULL the default pattern is used
+int tilize_context_create(tilize_context_t **context, const tilize_config_t *restrict tilize_config, const char *config_path){
+    // allocate context
+    tilize_context_t *ctx = malloc(sizeof(*ctx));
+    if(!ctx){
+        VERRPRINT(0, "Failed to allocate ctx");
+        return 1;
+    }
+    ctx->num_colors   = 0;
+    ctx->colors       = NULL;
+    ctx->masks        = NULL;
+    ctx->owned_masks  = NULL;
+    ctx->compiled     = MAPPED_FILE_NULL;
+    ctx->search       = NULL;
+    ctx->coarse       = NULL;
+
+    // load pattern texture
+    rgb24_texture_t pattern_texture = RGB24_TEXTURE_NULL;
+    if(!(config_path == NULL || tilize_config->pattern_path == NULL)){
+        // path provided
+        char pattern_path[256];
+        get_pattern_path(pattern_path, sizeof(pattern_path), tilize_config, config_path);
+
+        // load pattern as texture
+        if(load_png(&pattern_texture, pattern_path)){
+            VERRPRINT(0, "Failed to load pattern_texture");
+            tilize_context_destroy(ctx);
+            return 1;
+        }
+    }
+    else{
+        // path not provided, generating at runtime
+        // is based on default tilize config defined in `configuration.c` in `tilize_config_default()`
+        if(rgb24_texture_create(&pattern_texture, 8, 4)){
+            VERRPRINT(0, "Failed to create pattern_texture");
+            tilize_context_destroy(ctx);
+            return 1;
+        }
+        for(int i = 0; i < 4 * 8; ++i){ // lets just hope the compiler takes care of optimizing this
+            const int x = i % 8,
+                      y = i / 8;
+            if(x <= 1 || (x >= 4 && y <= 1)) pattern_texture.data[i] = RGB24(0xff, 0xff, 0xff);
+            else                             pattern_texture.data[i] = RGB24(0x00, 0x00, 0x00);
+        }
+    }
+
+    // split pattern_texture into pattern_atlas and clean
+    rgb24_atlas_t pattern_atlas = RGB24_ATLAS_NULL;
+    if(rgb24_atlas_from_texture(&pattern_atlas, &pattern_texture, tilize_config->tile_width, tilize_config->tile_height)){
+        VERRPRINT(0, "Failed to split pattern_texture into pattern_atlas");
+        rgb24_texture_destroy(&pattern_texture);
+        tilize_context_destroy(ctx);
+        return 1;
+    }
+    rgb24_texture_destroy(&pattern_texture);
+
+    // turn pattern_atlas into masks
+    ctx->tile_width   = pattern_atlas.tile_width;
+    ctx->tile_height  = pattern_atlas.tile_height;
+    ctx->num_patterns = pattern_atlas.tile_amount_x * pattern_atlas.tile_amount_y;
+    const int tile_size = ctx->tile_width * ctx->tile_height;
+    ctx->owned_masks = malloc((size_t)ctx->num_patterns * tile_size);
+    if(!ctx->owned_masks){
+        VERRPRINT(0, "Failed to allocate owned_masks");
+        rgb24_atlas_destroy(&pattern_atlas);
+        tilize_context_destroy(ctx);
+        return 1;
+    }
+    for(int pt_i = 0; pt_i < ctx->num_patterns; ++pt_i){
+        for(int i = 0; i < tile_size; ++i){
+            ctx->owned_masks[pt_i * tile_size + i] = pattern_atlas.data[pt_i][i].r >= 0x80;
+        }
+    }
+    ctx->masks = ctx->owned_masks;
+    rgb24_atlas_destroy(&pattern_atlas);
+
+    // copy colors
+    ctx->num_colors = tilize_config->num_colors;
+    ctx->colors = malloc(ctx->num_colors * sizeof(*ctx->colors));
+    if(!ctx->colors){
+        VERRPRINT(0, "Failed to allocate colors");
+        tilize_context_destroy(ctx);
+        return 1;
+    }
+    for(int i = 0; i < ctx->num_colors; ++i){
+        ctx->colors[i] = tilize_config->colors[i];
+    }
+
+    // get bckg_color and forg_color
+    if(tilize_config->bckg_color != -1){
+        ctx->col2_min = tilize_config->bckg_color;
+        ctx->col2_max = tilize_config->bckg_color + 1;
+    }
+    else{
+        ctx->col2_min = 0;
+        ctx->col2_max = ctx->num_colors;
+    }
+    if(tilize_config->forg_color != -1){
+        ctx->col1_min = tilize_config->forg_color;
+        ctx->col1_max = tilize_config->forg_color + 1;
+    }
+    else{
+        ctx->col1_min = 0;
+        ctx->col1_max = ctx->num_colors;
+    }
+
+    if(create_search(ctx)) return 1;
+    *context = ctx;
+    return 0;
+}
+// loads a context from the file at config_path, which is either a json configuration or one compiled with tilize_context_compile()
+// compiled configurations whose sources changed since compiling are ignored in favor of those sources
+// if config_path starts with TILIZE_BUILTIN_PREFIX, the builtin configuration of that name is used
+// if config_path is NULL the default configuration is used
+int tilize_context_load(tilize_context_t **context, const char *config_path){
+    char source_path[1024];
+
+    if(config_path && !strncmp(config_path, TILIZE_BUILTIN_PREFIX, strlen(TILIZE_BUILTIN_PREFIX))){
+        // builtin configuration
+        const char *name = config_path + strlen(TILIZE_BUILTIN_PREFIX);
+        for(int i = 0; i < num_builtins; ++i){
+            if(!strcmp(builtins[i].name, name)) return tilize_context_from_builtin(context, &builtins[i]);
+        }
+        VPRINTF(1, "There is no builtin configuration called %s, available ones are:\n", name);
+        for(int i = 0; i < num_builtins; ++i) VPRINTF(1, " %s%s\n", TILIZE_BUILTIN_PREFIX, builtins[i].name);
+        return 1;
+    }
+    else if(config_path){
+        // check for a compiled configuration
+        mapped_file_t file;
+        if(map_file(&file, config_path)){
+            VERRPRINT(0, "Failed to map config_path");
+            return 1;
+        }
+        if(!is_compiled(&file)){
+            // json, loaded below
+            unmap_file(&file);
+        }
+        else if(!compiled_valid(&file)){
+            VPRINTF(1, "%s is damaged or was compiled by a different version of Tilize, please compile it again\n", config_path);
+            unmap_file(&file);
+            return 1;
+        }
+        else if(!compiled_stale(&file)){
+            return context_from_compiled(context, &file);
+        }
+        else{
+            // sources changed, load those instead
+            const char *compiled_source_path = (const char *)file.data + sizeof(struct compiled_header);
+            VPRINTF(1, "Warning: The sources of %s changed since it was compiled, using them instead\n", config_path);
+            strncpy(source_path, compiled_source_path, sizeof(source_path) - 1);
+            source_path[sizeof(source_path) - 1] = 0;
+            config_path = source_path;
+            unmap_file(&file);
+        }
+    }
+
+    // load configuration
+    tilize_config_t tilize_config = TILIZE_CONFIG_NULL;
+    if(config_path ? tilize_config_load(&tilize_config, config_path) : tilize_config_default(&tilize_config)){
+        VERRPRINT(0, "Failed to load tilize_config");
+        tilize_config_free(&tilize_config);
+        return 1;
+    }
+    if(tilize_context_create(context, &tilize_config, config_path)){
+        VERRPRINT(0, "Failed to create context");
+        tilize_config_free(&tilize_config);
+        return 1;
+    }
+    tilize_config_free(&tilize_config);
+    return 0;
+}
+// compiles the json configuration at config_path into output_path, which tilize_context_load() can then load without parsing json or decoding the pattern image
+int tilize_context_compile(const char *config_path, const char *output_path){
+    int retcode = 0;
+    FILE *output_file = NULL;
+    char *temp_path   = NULL;
+
+    // load sources
+    tilize_config_t tilize_config = TILIZE_CONFIG_NULL;
+    if(tilize_config_load(&tilize_config, config_path)){
+        VERRPRINT(0, "Failed to load tilize_config");
+        tilize_config_free(&tilize_config);
+        return 1;
+    }
+    tilize_context_t *context = NULL;
+    if(tilize_context_create(&context, &tilize_config, config_path)){
+        VERRPRINT(0, "Failed to create context");
+        tilize_config_free(&tilize_config);
+        return 1;
+    }
+    // sources are remembered by their absolute paths, since the compiled configuration might be used from somewhere else
+    char pattern_path[256]           = "",
+         absolute_config_path[1024]  = "",
+         absolute_pattern_path[1024] = "";
+    if(tilize_config.pattern_path) get_pattern_path(pattern_path, sizeof(pattern_path), &tilize_config, config_path);
+    if(get_absolute_path(absolute_config_path, sizeof(absolute_config_path), config_path) ||
+       (pattern_path[0] && get_absolute_path(absolute_pattern_path, sizeof(absolute_pattern_path), pattern_path))){
+        VERRPRINT(0, "Failed to get absolute paths of sources");
+        tilize_context_destroy(context);
+        tilize_config_free(&tilize_config);
+        return 1;
+    }
+
+    // fill header
+    struct compiled_header header;
+    memset(&header, 0, sizeof(header));
+    header.magic               = COMPILED_MAGIC;
+    header.version             = COMPILED_VERSION;
+    header.tile_width          = context->tile_width;
+    header.tile_height         = context->tile_height;
+    header.num_patterns        = context->num_patterns;
+    header.num_colors          = context->num_colors;
+    header.config_path_length  = strlen(absolute_config_path) + 1;
+    header.pattern_path_length = absolute_pattern_path[0] ? strlen(absolute_pattern_path) + 1 : 0;
+    header.bckg_color          = tilize_config.bckg_color;
+    header.forg_color          = tilize_config.forg_color;
+    if(get_file_stamp(config_path, &header.config_mtime, &header.config_size) ||
+       (pattern_path[0] && get_file_stamp(pattern_path, &header.pattern_mtime, &header.pattern_size))){
+        VERRPRINT(0, "Failed to get stamps of sources");
+        retcode = 1;
+        goto _clean_and_exit;
+    }
+
+    // put everything after the header together
+    const size_t colors_size = (size_t)context->num_colors * 3,
+                 masks_size  = (size_t)context->num_patterns * context->tile_width * context->tile_height,
+                 body_size   = header.config_path_length + header.pattern_path_length + colors_size + masks_size;
+    unsigned char *body = malloc(body_size);
+    if(!body){
+        VERRPRINT(0, "Failed to allocate body");
+        retcode = 1;
+        goto _clean_and_exit;
+    }
+    unsigned char *current = body;
+    memcpy(current, absolute_config_path, header.config_path_length);   current += header.config_path_length;
+    memcpy(current, absolute_pattern_path, header.pattern_path_length); current += header.pattern_path_length;
+    for(int i = 0; i < context->num_colors; ++i){
+        *current++ = context->colors[i].r;
+        *current++ = context->colors[i].g;
+        *current++ = context->colors[i].b;
+    }
+    memcpy(current, context->masks, masks_size);
+    header.checksum = fnv1a(FNV1A_BASIS, body, body_size);
+
+    // write it to a temporary file that then replaces output_path, contexts loaded from output_path keep using its masks through their mapping of the old file
+    temp_path = malloc(strlen(output_path) + 32);
+    if(!temp_path){
+        VERRPRINT(0, "Failed to allocate temp_path");
+        free(body);
+        retcode = 1;
+        goto _clean_and_exit;
+    }
+    sprintf(temp_path, "%s.tmp%ld", output_path, (long)getpid());
+    output_file = fopen(temp_path, "wb");
+    if(!output_file){
+        VERRPRINTF(0, "Failed to open %s", temp_path);
+        free(body);
+        retcode = 1;
+        goto _clean_and_exit;
+    }
+    if(fwrite(&header, sizeof(header), 1, output_file) != 1 || fwrite(body, 1, body_size, output_file) != body_size){
+        VERRPRINTF(0, "Failed to write %s", temp_path);
+        free(body);
+        retcode = 1;
+        goto _clean_and_exit;
+    }
+    free(body);
+
+    // clean and exit
+    _clean_and_exit:;
+    if(output_file && fclose(output_file)){
+        VERRPRINTF(0, "Failed to close %s", temp_path);
+        retcode = 1;
+    }
+    #if defined(_WIN32)
+        if(output_file && !retcode) remove(output_path); // rename() doesn't replace files there
+    #endif
+    if(output_file && !retcode && rename(temp_path, output_path)){
+        VERRPRINTF(0, "Failed to rename %s to %s", temp_path, output_path);
+        retcode = 1;
+    }
+    if(output_file && retcode) remove(temp_path);
+    free(temp_path);
+    tilize_context_destroy(context);
+    tilize_config_free(&tilize_config);
+    return retcode;
+}
+// creates a context from builtin, which has to stay around for as long as the context does
+int tilize_context_from_builtin(tilize_context_t **context, const tilize_builtin_t *builtin){
+    // allocate context
+    tilize_context_t *ctx = malloc(sizeof(*ctx));
+    if(!ctx){
+        VERRPRINT(0, "Failed to allocate ctx");
+        return 1;
+    }
+    ctx->compiled     = MAPPED_FILE_NULL;
+    ctx->search       = NULL;
+    ctx->coarse       = NULL;
+    ctx->owned_masks  = NULL;
+    ctx->masks        = builtin->masks;
+    ctx->tile_width   = builtin->tile_width;
+    ctx->tile_height  = builtin->tile_height;
+    ctx->num_patterns = builtin->num_patterns;
+    ctx->num_colors   = builtin->num_colors;
+
+    // copy colors
+    ctx->colors = malloc(ctx->num_colors * sizeof(*ctx->colors));
+    if(!ctx->colors){
+        VERRPRINT(0, "Failed to allocate colors");
+        tilize_context_destroy(ctx);
+        return 1;
+    }
+    for(int i = 0; i < ctx->num_colors; ++i){
+        ctx->colors[i] = builtin->colors[i];
+    }
+
+    // get bckg_color and forg_color
+    ctx->col2_min = builtin->bckg_color != -1 ? builtin->bckg_color     : 0;
+    ctx->col2_max = builtin->bckg_color != -1 ? builtin->bckg_color + 1 : ctx->num_colors;
+    ctx->col1_min = builtin->forg_color != -1 ? builtin->forg_color     : 0;
+    ctx->col1_max = builtin->forg_color != -1 ? builtin->forg_color + 1 : ctx->num_colors;
+
+    if(create_search(ctx)) return 1;
+    *context = ctx;
+    return 0;
+}
+// describes context as a builtin configuration, which points into context and so is only valid as long as it is
+void tilize_context_get_builtin(const tilize_context_t *context, tilize_builtin_t *builtin){
+    builtin->name         = NULL;
+    builtin->tile_width   = context->tile_width;
+    builtin->tile_height  = context->tile_height;
+    builtin->num_patterns = context->num_patterns;
+    builtin->num_colors   = context->num_colors;
+    builtin->colors       = context->colors;
+    builtin->masks        = context->masks;
+    builtin->bckg_color   = context->col2_max - context->col2_min == 1 ? context->col2_min : -1;
+    builtin->forg_color   = context->col1_max - context->col1_min == 1 ? context->col1_min : -1;
+}
+// makes builtins available to tilize_context_load() as `builtin:[name]`, builtins has to stay around for as long as it's used
+void tilize_set_builtins(const tilize_builtin_t *new_builtins, int new_num_builtins){
+    builtins     = new_builtins;
+    num_builtins = new_num_builtins;
+}
+// destroyes context
+void tilize_context_destroy(tilize_context_t *context){
+    if(!context) return;
+    if(context->colors) free(context->colors);
+    if(context->owned_masks) free(context->owned_masks);
+    search_destroy(context->search);
+    search_destroy(context->coarse);
+    unmap_file(&context->compiled);
+    free(context);
+}
+
+// gets the size of the tiles context works with
+void tilize_context_tile_size(const tilize_context_t *context, int *tile_width, int *tile_height){
+    if(tile_width)  *tile_width  = context->tile_width;
+    if(tile_height) *tile_height = context->tile_height;
+}
+// gets a hash of everything about context that changes results, to tell whether results were made with the same configuration
+uint32_t tilize_context_hash(const tilize_context_t *context){
+    const int32_t sizes[] = {context->tile_width, context->tile_height, context->num_patterns, context->num_colors,
+                             context->col1_min, context->col1_max, context->col2_min, context->col2_max};
+    uint32_t hash = fnv1a(FNV1A_BASIS, sizes, sizeof(sizes));
+    hash = fnv1a(hash, context->colors, context->num_colors * sizeof(*context->colors));
+    return fnv1a(hash, context->masks, (size_t)context->num_patterns * context->tile_width * context->tile_height);
+}
+// gets a hash of the size and pixels of texture
+uint32_t tilize_texture_hash(const rgb24_texture_t *texture){
+    const int32_t sizes[] = {texture->width, texture->height};
+    return fnv1a(fnv1a(FNV1A_BASIS, sizes, sizeof(sizes)), texture->data, (size_t)texture->width * texture->height * sizeof(*texture->data));
+}
+
+// creates tile_map for tilizing input_texture with context, with every tile being TILIZE_TILE_TODO
+int tilize_tile_map_create(tilize_tile_map_t *tile_map, const tilize_context_t *context, const rgb24_texture_t *input_texture){
+    tile_map->image_width   = input_texture->width;
+    tile_map->image_height  = input_texture->height;
+    tile_map->tile_width    = context->tile_width;
+    tile_map->tile_height   = context->tile_height;
+    tile_map->tile_amount_x = (input_texture->width + context->tile_width - 1) / context->tile_width;
+    tile_map->tile_amount_y = (input_texture->height + context->tile_height - 1) / context->tile_height;
+    tile_map->config_hash   = tilize_context_hash(context);
+    tile_map->input_hash    = tilize_texture_hash(input_texture);
+    tile_map->tiles         = malloc((size_t)tile_map->tile_amount_x * tile_map->tile_amount_y * sizeof(*tile_map->tiles));
+    if(!tile_map->tiles){
+        VERRPRINT(0, "Failed to allocate tile_map->tiles");
+        return 1;
+    }
+    for(int i = 0; i < tile_map->tile_amount_x * tile_map->tile_amount_y; ++i) tile_map->tiles[i] = (tilize_tile_t){TILIZE_TILE_TODO, 0, 0};
+    return 0;
+}
+// saves tile_map to the file at path (stdout for "-"), in the byte order of the machine saving it
+int tilize_tile_map_save(const tilize_tile_map_t *tile_map, const char *path){
+    const size_t num_tiles = (size_t)tile_map->tile_amount_x * tile_map->tile_amount_y;
+    struct tile_map_header header;
+    memset(&header, 0, sizeof(header));
+    header.magic         = TILE_MAP_MAGIC;
+    header.version       = TILE_MAP_VERSION;
+    header.checksum      = fnv1a(FNV1A_BASIS, tile_map->tiles, num_tiles * sizeof(*tile_map->tiles));
+    header.image_width   = tile_map->image_width;
+    header.image_height  = tile_map->image_height;
+    header.tile_width    = tile_map->tile_width;
+    header.tile_height   = tile_map->tile_height;
+    header.tile_amount_x = tile_map->tile_amount_x;
+    header.tile_amount_y = tile_map->tile_amount_y;
+    header.config_hash   = tile_map->config_hash;
+    header.input_hash    = tile_map->input_hash;
+
+    FILE *file = strcmp(path, "-") ? fopen(path, "wb") : stdout; // "-" is stdout
+    if(!file){
+        VERRPRINTF(0, "Failed to open %s", path);
+        return 1;
+    }
+    int ret_code = 0;
+    if(fwrite(&header, sizeof(header), 1, file) != 1 || fwrite(tile_map->tiles, sizeof(*tile_map->tiles), num_tiles, file) != num_tiles){
+        VERRPRINTF(0, "Failed to write %s", path);
+        ret_code = 1;
+    }
+    if(file == stdout ? fflush(file) : fclose(file)){
+        VERRPRINTF(0, "Failed to close %s", path);
+        ret_code = 1;
+    }
+    return ret_code;
+}
+// loads tile_map from the file at path (stdin for "-"), saved with tilize_tile_map_save()
+int tilize_tile_map_load(tilize_tile_map_t *tile_map, const char *path){
+    mapped_file_t file = MAPPED_FILE_NULL;
+    if(map_file(&file, path)){
+        VERRPRINTF(0, "Failed to map %s", path);
+        return 1;
+    }
+    struct tile_map_header header;
+    if(file.size < sizeof(header)){
+        VERRPRINTF(0, "%s is not a tile map", path);
+        unmap_file(&file);
+        return 1;
+    }
+    memcpy(&header, file.data, sizeof(header));
+    const size_t num_tiles = (size_t)header.tile_amount_x * header.tile_amount_y;
+    // the tile amounts have to fit the image, since everything using tile maps relies on that
+    if(header.magic != TILE_MAP_MAGIC || header.version != TILE_MAP_VERSION || header.tile_amount_x > INT_MAX / (header.tile_amount_y ? header.tile_amount_y : 1) ||
+       header.image_width == 0 || header.image_height == 0 || header.tile_width == 0 || header.tile_height == 0 ||
+       header.image_width > INT_MAX || header.image_height > INT_MAX || header.tile_width > INT_MAX || header.tile_height > INT_MAX ||
+       header.tile_amount_x != ((uint64_t)header.image_width + header.tile_width - 1) / header.tile_width ||
+       header.tile_amount_y != ((uint64_t)header.image_height + header.tile_height - 1) / header.tile_height ||
+       file.size != sizeof(header) + num_tiles * sizeof(*tile_map->tiles) ||
+       fnv1a(FNV1A_BASIS, file.data + sizeof(header), num_tiles * sizeof(*tile_map->tiles)) != header.checksum){
+        VERRPRINTF(0, "%s is not a tile map, was saved on a different kind of machine or is damaged", path);
+        unmap_file(&file);
+        return 1;
+    }
+    tile_map->tiles = malloc(num_tiles * sizeof(*tile_map->tiles));
+    if(!tile_map->tiles){
+        VERRPRINT(0, "Failed to allocate tile_map->tiles");
+        unmap_file(&file);
+        return 1;
+    }
+    memcpy(tile_map->tiles, file.data + sizeof(header), num_tiles * sizeof(*tile_map->tiles));
+    tile_map->image_width   = header.image_width;
+    tile_map->image_height  = header.image_height;
+    tile_map->tile_width    = header.tile_width;
+    tile_map->tile_height   = header.tile_height;
+    tile_map->tile_amount_x = header.tile_amount_x;
+    tile_map->tile_amount_y = header.tile_amount_y;
+    tile_map->config_hash   = header.config_hash;
+    tile_map->input_hash    = header.input_hash;
+    unmap_file(&file);
+    return 0;
+}
+// copies the tiles of from that aren't TILIZE_TILE_TODO or TILIZE_TILE_SKIP into tile_map, both have to be made for the same image and configuration
+int tilize_tile_map_merge(tilize_tile_map_t *restrict tile_map, const tilize_tile_map_t *restrict from){
+    if(tile_map->image_width != from->image_width || tile_map->image_height != from->image_height ||
+       tile_map->tile_width != from->tile_width || tile_map->tile_height != from->tile_height ||
+       tile_map->tile_amount_x != from->tile_amount_x || tile_map->tile_amount_y != from->tile_amount_y ||
+       tile_map->config_hash != from->config_hash || tile_map->input_hash != from->input_hash){
+        VERRPRINT(0, "Tile maps were made for different images or configurations");
+        return 1;
+    }
+    for(int i = 0; i < tile_map->tile_amount_x * tile_map->tile_amount_y; ++i){
+        if(from->tiles[i].pattern >= 0) tile_map->tiles[i] = from->tiles[i];
+    }
+    return 0;
+}
+// destroyes tile_map
+void tilize_tile_map_destroy(tilize_tile_map_t *tile_map){
+    free(tile_map->tiles);
+    *tile_map = TILIZE_TILE_MAP_NULL;
+}
+// draws tile_map, made with context, into output_texture, which gets created by this function
+int tilize_tile_map_render(const tilize_context_t *context, const tilize_tile_map_t *tile_map, rgb24_texture_t *output_texture){
+    if(check_tile_map(context, tile_map)){
+        VERRPRINT(0, "tile_map wasn't made with context");
+        return 1;
+    }
+    rgb24_atlas_t output_atlas = RGB24_ATLAS_NULL;
+    if(rgb24_atlas_create(&output_atlas, context->tile_width, context->tile_height, tile_map->tile_amount_x, tile_map->tile_amount_y, tile_map->image_width, tile_map->image_height)){
+        VERRPRINT(0, "Failed to create output_atlas");
+        return 1;
+    }
+    if(draw_tile_map(context, tile_map, &output_atlas, NULL) || rgb24_texture_from_atlas(output_texture, &output_atlas)){
+        VERRPRINT(0, "Failed to draw tile_map into output_texture");
+        rgb24_atlas_destroy(&output_atlas);
+        return 1;
+    }
+    rgb24_atlas_destroy(&output_atlas);
+    return 0;
+}
+// returns whether the file at path starts like a tile map saved with tilize_tile_map_save()
+int tilize_tile_map_is_file(const char *path){
+    FILE *file = fopen(path, "rb");
+    if(!file) return 0;
+    uint32_t magic;
+    const int is_tile_map = fread(&magic, sizeof(magic), 1, file) == 1 && magic == TILE_MAP_MAGIC;
+    fclose(file);
+    return is_tile_map;
+}
+// sets the pattern of every tile of tile_map that overlaps rect to pattern
+void tilize_tile_map_mark_rect(tilize_tile_map_t *tile_map, tilize_rect_t rect, int32_t pattern){
+    if(rect.width < 1 || rect.height < 1) return;
+    int x_min = rect.x / tile_map->tile_width,
+        y_min = rect.y / tile_map->tile_height,
+        x_max = (int)(((long long)rect.x + rect.width - 1) / tile_map->tile_width),
+        y_max = (int)(((long long)rect.y + rect.height - 1) / tile_map->tile_height);
+    if(x_min < 0)                        x_min = 0;
+    if(y_min < 0)                        y_min = 0;
+    if(x_max >= tile_map->tile_amount_x) x_max = tile_map->tile_amount_x - 1;
+    if(y_max >= tile_map->tile_amount_y) y_max = tile_map->tile_amount_y - 1;
+    for(int y = y_min; y <= y_max; ++y){
+        for(int x = x_min; x <= x_max; ++x) tile_map->tiles[y * tile_map->tile_amount_x + x].pattern = pattern;
+    }
+}
+// sets the pattern of every tile of tile_map with a pixel that differs between old_texture and new_texture to pattern
+// both have to be the size of the image tile_map was made for
+int tilize_tile_map_mark_changed(tilize_tile_map_t *tile_map, const rgb24_texture_t *old_texture, const rgb24_texture_t *new_texture, int32_t pattern){
+    if(old_texture->width != tile_map->image_width || old_texture->height != tile_map->image_height ||
+       new_texture->width != tile_map->image_width || new_texture->height != tile_map->image_height){
+        VERRPRINT(0, "old_texture or new_texture isn't the size of the image tile_map was made for");
+        return 1;
+    }
+    for(int ty = 0; ty < tile_map->tile_amount_y; ++ty){
+        const int y_min = ty * tile_map->tile_height,
+                  y_max = y_min + tile_map->tile_height < tile_map->image_height ? y_min + tile_map->tile_height : tile_map->image_height;
+        for(int tx = 0; tx < tile_map->tile_amount_x; ++tx){
+            const int x_min = tx * tile_map->tile_width,
+                      width = x_min + tile_map->tile_width < tile_map->image_width ? tile_map->tile_width : tile_map->image_width - x_min;
+            for(int y = y_min; y < y_max; ++y){
+                const size_t row = (size_t)y * tile_map->image_width + x_min;
+                if(memcmp(&old_texture->data[row], &new_texture->data[row], width * sizeof(*new_texture->data))){
+                    tile_map->tiles[ty * tile_map->tile_amount_x + tx].pattern = pattern;
+                    break;
+                }
+            }
+        }
+    }
+    return 0;
+}
+// copies the pixels of every TILIZE_TILE_SKIP tile of tile_map from source_texture into output_texture, both the size of the image tile_map was made for
+void tilize_tile_map_copy_skipped(const tilize_tile_map_t *tile_map, rgb24_texture_t *output_texture, const rgb24_texture_t *source_texture){
+    for(int ty = 0; ty < tile_map->tile_amount_y; ++ty){
+        const int y_min = ty * tile_map->tile_height,
+                  y_max = y_min + tile_map->tile_height < tile_map->image_height ? y_min + tile_map->tile_height : tile_map->image_height;
+        for(int tx = 0; tx < tile_map->tile_amount_x; ++tx){
+            if(tile_map->tiles[ty * tile_map->tile_amount_x + tx].pattern != TILIZE_TILE_SKIP) continue;
+            const int x_min = tx * tile_map->tile_width,
+                      width = x_min + tile_map->tile_width < tile_map->image_width ? tile_map->tile_width : tile_map->image_width - x_min;
+            for(int y = y_min; y < y_max; ++y){
+                const size_t row = (size_t)y * tile_map->image_width + x_min;
+                memcpy(&output_texture->data[row], &source_texture->data[row], width * sizeof(*output_texture->data));
+            }
+        }
+    }
+}
+
+// tilizes input_texture into output_texture, which gets created by this function
+// options may be NULL, in which case TILIZE_PROCESS_OPTIONS_NULL is used
+// returns 0 on success (including running out of time with options->deadline_ms, output_texture has the best results found by then), 1 on failure and 2 if cancelled through options->running (output_texture is destroyed then)
+int tilize_process(const tilize_context_t *context, const rgb24_texture_t *restrict input_texture, rgb24_texture_t *restrict output_texture, const tilize_process_options_t *options){
+    const tilize_process_options_t default_options = TILIZE_PROCESS_OPTIONS_NULL;
+    if(!options) options = &default_options;
+    search_t                   *coarse       = NULL;
+    if(options->deadline_ms > 0 && get_coarse(context, &coarse)) return 1;
+    const int                   progressive  = coarse != NULL;
+    const ms_t                  deadline     = progressive ? current_ms() + options->deadline_ms : 0;
+    const int                   approximate  = search_approximates(context->search, options->quality);
+    tilize_tile_map_t          *tile_map     = options->tile_map;
+    int                         ret_code     = 1;
+    thread_pool_t              *pool         = options->pool;
+    planar_atlas_t              split_tiles  = PLANAR_ATLAS_NULL;
+    const planar_atlas_t       *input_tiles  = options->input_tiles;
+    rgb24_atlas_t               output_atlas = RGB24_ATLAS_NULL;
+    struct process_thread_data *part_data    = NULL;
+    search_result_t            *tile_results = NULL;
+    struct tile_priority       *priorities   = NULL;
+    int                        *todo         = NULL,
+                               *tile_order   = NULL;
+
+    if(options->quality >= 1 && options->quality < 100 && !approximate){
+        VPRINT(1, "Warning: This configuration has too few colors and patterns for `--quality` to make searching faster, searching exactly\n");
+    }
+
+    // get pool to run on, starting one just for this call if none was given
+    if(!pool && options->num_threads > 1 && thread_pool_create(&pool, options->num_threads - 1)){
+        VERRPRINT(0, "Failed to create pool");
+        pool = NULL;
+        goto _clean_and_exit;
+    }
+
+    // output_atlas for the results, with as many tiles as input_texture is split into
+    const int tile_amount_x = (input_texture->width + context->tile_width - 1) / context->tile_width,
+              tile_amount_y = (input_texture->height + context->tile_height - 1) / context->tile_height,
+              num_tiles     = tile_amount_x * tile_amount_y;
+    if(input_tiles && (input_tiles->tile_width != context->tile_width || input_tiles->tile_height != context->tile_height ||
+                       input_tiles->tile_amount_x != tile_amount_x || input_tiles->tile_amount_y != tile_amount_y)){
+        VERRPRINT(0, "options->input_tiles wasn't split from input_texture with the tile size of context");
+        goto _clean_and_exit;
+    }
+    if(rgb24_atlas_create(&output_atlas, context->tile_width, context->tile_height, tile_amount_x, tile_amount_y, input_texture->width, input_texture->height)){
+        VERRPRINT(0, "Failed to create output_atlas");
+        output_atlas = RGB24_ATLAS_NULL;
+        goto _clean_and_exit;
+    }
+
+    // tiles to search, either all of them or only those of tile_map still to do, with the others drawn right away
+    int num_todo = num_tiles;
+    if(tile_map){
+        if(tile_map->image_width != input_texture->width || tile_map->image_height != input_texture->height || check_tile_map(context, tile_map)){
+            VERRPRINT(0, "options->tile_map wasn't made for input_texture and context");
+            goto _clean_and_exit;
+        }
+        todo = malloc(num_tiles * sizeof(*todo));
+        if(!todo){
+            VERRPRINT(0, "Failed to allocate todo");
+            goto _clean_and_exit;
+        }
+        if(draw_tile_map(context, tile_map, &output_atlas, options)){
+            VERRPRINT(0, "Failed to draw tile_map");
+            goto _clean_and_exit;
+        }
+        num_todo = 0;
+        for(int i = 0; i < num_tiles; ++i) if(tile_map->tiles[i].pattern == TILIZE_TILE_TODO) todo[num_todo++] = i;
+    }
+
+    // split input_texture into input_tiles unless that was done already, only the tiles to search are ever looked at
+    if(!input_tiles){
+        if(planar_atlas_from_texture_tiles(&split_tiles, input_texture, context->tile_width, context->tile_height, todo, num_todo)){
+            VERRPRINT(0, "Failed to split input_texture into input_tiles");
+            goto _clean_and_exit;
+        }
+        input_tiles = &split_tiles;
+    }
+
+    // do the thing
+    // with a deadline, every tile first gets a result from coarse, and then the worst ones are searched properly until time runs out
+    int num_parts = (thread_pool_num_threads(pool) + 1) * PARTS_PER_THREAD;
+    if(num_parts > num_todo) num_parts = num_todo;
+    if(num_parts < 1)        num_parts = 1;
+    part_data = malloc(num_parts * sizeof(*part_data));
+    if(progressive || approximate || tile_map) tile_results = malloc(num_tiles * sizeof(*tile_results));
+    if(progressive){
+        priorities = malloc(num_tiles * sizeof(*priorities));
+        tile_order = malloc(num_tiles * sizeof(*tile_order));
+    }
+    if(!part_data || ((progressive || approximate || tile_map) && !tile_results) || (progressive && (!priorities || !tile_order))){
+        VERRPRINT(0, "Failed to allocate part_data, tile_results, priorities or tile_order");
+        goto _clean_and_exit;
+    }
+    atomic_int next_tile;
+    atomic_store(&next_tile, 0);
+    for(int i = 0; i < num_parts; ++i){
+        part_data[i].ct_min       = todo ? 0 : (int)((long long)num_tiles * i / num_parts);
+        part_data[i].ct_max       = todo ? num_todo : (int)((long long)num_tiles * (i + 1) / num_parts);
+        part_data[i].context      = context;
+        part_data[i].input_tiles  = input_tiles;
+        part_data[i].output_atlas = &output_atlas;
+        part_data[i].options      = options;
+        part_data[i].search       = progressive ? coarse : context->search;
+        part_data[i].tile_results = tile_results;
+        part_data[i].tile_order   = todo;
+        part_data[i].next_tile    = &next_tile;
+        part_data[i].deadline     = 0;
+        part_data[i].tile_map     = progressive ? NULL : tile_map; // coarse results aren't final
+    }
+    int total_ret_code = thread_pool_run(pool, &process_loop, part_data, sizeof(*part_data), num_parts);
+    if(progressive && !total_ret_code){
+        // refine worst tiles first, tiles already drawn perfectly can't get any better
+        int num_refine = 0;
+        for(int i = 0; i < num_todo; ++i){
+            const int tile = todo ? todo[i] : i;
+            if(!tile_results[tile].difference) continue;
+            priorities[num_refine].difference = tile_results[tile].difference;
+            priorities[num_refine].tile       = tile;
+            ++num_refine;
+        }
+        qsort(priorities, num_refine, sizeof(*priorities), compare_priorities);
+        for(int i = 0; i < num_refine; ++i) tile_order[i] = priorities[i].tile;
+        atomic_store(&next_tile, 0);
+        for(int i = 0; i < num_parts; ++i){
+            part_data[i].ct_min       = 0;
+            part_data[i].ct_max       = num_refine;
+            part_data[i].search       = context->search;
+            part_data[i].tile_order   = tile_order;
+            part_data[i].deadline     = deadline;
+            part_data[i].tile_map     = tile_map;
+        }
+        total_ret_code = thread_pool_run(pool, &process_loop, part_data, sizeof(*part_data), num_parts);
+        const int refined = atomic_load(&next_tile) < num_refine ? atomic_load(&next_tile) : num_refine;
+        VPRINTF(2, "Refined %i of %i imperfect tiles before the deadline\n", refined, num_refine);
+    }
+    if(approximate && !total_ret_code && report_quality(context, input_tiles, tile_results, todo, num_todo, options->quality)) total_ret_code = 1;
+    planar_atlas_destroy(&split_tiles);
+    if(total_ret_code & 1){
+        VERRPRINT(0, "Failed to complete all parts");
+        goto _clean_and_exit;
+    }
+    else if(total_ret_code & 2){
+        ret_code = 2;
+        goto _clean_and_exit;
+    }
+
+    // put results into tile_map (the coarse ones of progressive tiles left unrefined aren't yet) and output_texture
+    if(tile_map && options->tile_map_mtx) mtx_lock(options->tile_map_mtx);
+    for(int i = 0; tile_map && i < num_todo; ++i){
+        tilize_tile_t *tile = &tile_map->tiles[todo[i]];
+        tile->pattern = tile_results[todo[i]].pattern;
+        tile->col1    = tile_results[todo[i]].col1;
+        tile->col2    = tile_results[todo[i]].col2;
+    }
+    if(tile_map && options->tile_map_mtx) mtx_unlock(options->tile_map_mtx);
+    if(rgb24_texture_from_atlas(output_texture, &output_atlas)){
+        VERRPRINT(0, "Failed to generate output_texture from output_atlas");
+        goto _clean_and_exit;
+    }
+    ret_code = 0;
+
+_clean_and_exit:
+    free(part_data);
+    free(tile_results);
+    free(priorities);
+    free(todo);
+    free(tile_order);
+    rgb24_atlas_destroy(&output_atlas);
+    planar_atlas_destroy(&split_tiles);
+    if(pool != options->pool) thread_pool_destroy(pool);
+    return ret_code;
+}
+
+// performs the loop that does the thing
+static int process_loop(void *input_data_void){
+    // macros for convenience
+    #define input_data    ((struct process_thread_data *)input_data_void)
+    #define input_tiles   (input_data->input_tiles)
+    #define output_atlas  (input_data->output_atlas)
+    #define context       (input_data->context)
+    const int ct_min = input_data->ct_min,
+              ct_max = input_data->ct_max;
+    search_scratch_t *scratch;
+    if(search_scratch_create(&scratch, input_data->search, input_data->options->quality)){
+        VERRPRINT(0, "Failed to create scratch");
+        return 1;
+    }
+    rgb24_texture_t best_pattern_colorized = RGB24_TEXTURE_NULL;
+    if(rgb24_texture_create(&best_pattern_colorized, context->tile_width, context->tile_height)){
+        VERRPRINT(0, "Failed to create best_pattern_colorized");
+        search_scratch_destroy(scratch);
+        return 1;
+    }
+    const int *tile_order = input_data->tile_order;
+    search_result_t results[PROCESS_CHUNK_TILES];
+    for(int chunk_min = ct_min; chunk_min < ct_max; chunk_min += PROCESS_CHUNK_TILES){
+        if(input_data->options->running && !atomic_load(input_data->options->running)){ // exit if told to do so
+            rgb24_texture_destroy(&best_pattern_colorized);
+            search_scratch_destroy(scratch);
+            return 2;
+        }
+        if(tile_order){
+            // take the next tiles in order, shared with all other parts, unless time is up
+            if(input_data->deadline && current_ms() >= input_data->deadline) break;
+            chunk_min = atomic_fetch_add(input_data->next_tile, PROCESS_CHUNK_TILES);
+            if(chunk_min >= ct_max) break;
+        }
+
+        // do the thing
+        const int chunk_tiles = ct_max - chunk_min < PROCESS_CHUNK_TILES ? ct_max - chunk_min : PROCESS_CHUNK_TILES;
+        search_tiles(input_data->search, scratch, input_tiles, tile_order, chunk_min, chunk_tiles, results);
+
+        for(int i = 0; i < chunk_tiles; ++i){
+            const int           ct_i = tile_order ? tile_order[chunk_min + i] : chunk_min + i;
+            const tilize_tile_t tile = {results[i].pattern, results[i].col1, results[i].col2};
+            draw_tile(context, output_atlas, input_data->options, &best_pattern_colorized, ct_i, &tile);
+            if(input_data->tile_results) input_data->tile_results[ct_i] = results[i];
+        }
+        if(input_data->tile_map){
+            if(input_data->options->tile_map_mtx) mtx_lock(input_data->options->tile_map_mtx);
+            for(int i = 0; i < chunk_tiles; ++i){
+                const int ct_i = tile_order ? tile_order[chunk_min + i] : chunk_min + i;
+                input_data->tile_map->tiles[ct_i] = (tilize_tile_t){results[i].pattern, results[i].col1, results[i].col2};
+            }
+            if(input_data->options->tile_map_mtx) mtx_unlock(input_data->options->tile_map_mtx);
+        }
+    }
+    rgb24_texture_destroy(&best_pattern_colorized);
+    search_scratch_destroy(scratch);
+    return 0;
+    #undef input_data
+    #undef input_tiles
+    #undef output_atlas
+    #undef context
+}
+// compares two tile_prioritys, those with a higher difference first
+static int compare_priorities(const void *a, const void *b){
+    const struct tile_priority *pa = a,
+                               *pb = b;
+    if(pa->difference != pb->difference) return pa->difference > pb->difference ? -1 : 1;
+    return (pa->tile > pb->tile) - (pa->tile < pb->tile);
+}
+// searches a sample of the num_todo tiles todo (or the first num_todo if it's NULL) of input_tiles exactly and prints how much worse tile_results are, which were found with quality
+static int report_quality(const tilize_context_t *context, const planar_atlas_t *input_tiles, const search_result_t *tile_results, const int *todo, int num_todo, int quality){
+    if(num_todo < 1) return 0;
+    const int num_samples = num_todo < QUALITY_SAMPLE_TILES ? num_todo : QUALITY_SAMPLE_TILES;
+    int              *samples  = malloc(num_samples * sizeof(*samples));
+    search_result_t  *exact    = malloc(num_samples * sizeof(*exact));
+    search_scratch_t *scratch  = NULL;
+    int               ret_code = 1;
+    if(!samples || !exact){
+        VERRPRINT(0, "Failed to allocate samples or exact");
+        goto _clean_and_exit;
+    }
+    if(search_scratch_create(&scratch, context->search, 100)){
+        VERRPRINT(0, "Failed to create scratch");
+        goto _clean_and_exit;
+    }
+
+    // tiles spread evenly over the image
+    for(int i = 0; i < num_samples; ++i){
+        const int todo_i = (int)((long long)num_todo * i / num_samples);
+        samples[i] = todo ? todo[todo_i] : todo_i;
+    }
+    search_tiles(context->search, scratch, input_tiles, samples, 0, num_samples, exact);
+    unsigned long long approximate_sum = 0,
+                       exact_sum       = 0;
+    for(int i = 0; i < num_samples; ++i){
+        approximate_sum += tile_results[samples[i]].difference;
+        exact_sum       += exact[i].difference;
+    }
+    VPRINTF(1, "Searching with a quality of %i%% made %i sampled tiles %.2f%% worse than searching exactly\n",
+            quality, num_samples, exact_sum ? 100.0 * (double)(approximate_sum - exact_sum) / (double)exact_sum : 0.0);
+    ret_code = 0;
+
+_clean_and_exit:
+    search_scratch_destroy(scratch);
+    free(samples);
+    free(exact);
+    return ret_code;
+}
+// checks whether tile_map can be drawn with context, returns 1 if not
+static int check_tile_map(const tilize_context_t *context, const tilize_tile_map_t *tile_map){
+    if(tile_map->tile_width != context->tile_width || tile_map->tile_height != context->tile_height ||
+       tile_map->tile_amount_x != (tile_map->image_width + context->tile_width - 1) / context->tile_width ||
+       tile_map->tile_amount_y != (tile_map->image_height + context->tile_height - 1) / context->tile_height ||
+       tile_map->config_hash != tilize_context_hash(context)){
+        return 1;
+    }
+    for(int i = 0; i < tile_map->tile_amount_x * tile_map->tile_amount_y; ++i){
+        const tilize_tile_t *tile = &tile_map->tiles[i];
+        if(tile->pattern == TILIZE_TILE_TODO || tile->pattern == TILIZE_TILE_SKIP) continue;
+        if(tile->pattern < 0 || tile->pattern >= context->num_patterns ||
+           tile->col1 < context->col1_min || tile->col1 >= context->col1_max || tile->col2 < context->col2_min || tile->col2 >= context->col2_max){
+            return 1;
+        }
+    }
+    return 0;
+}
+// draws every tile of tile_map into output_atlas, made for it
+// options may be NULL, otherwise tiles are handed to options->tile_callback
+static int draw_tile_map(const tilize_context_t *context, const tilize_tile_map_t *tile_map, rgb24_atlas_t *output_atlas, const tilize_process_options_t *options){
+    rgb24_texture_t tile_texture = RGB24_TEXTURE_NULL;
+    if(rgb24_texture_create(&tile_texture, context->tile_width, context->tile_height)){
+        VERRPRINT(0, "Failed to create tile_texture");
+        return 1;
+    }
+    for(int i = 0; i < tile_map->tile_amount_x * tile_map->tile_amount_y; ++i) draw_tile(context, output_atlas, options, &tile_texture, i, &tile_map->tiles[i]);
+    rgb24_texture_destroy(&tile_texture);
+    return 0;
+}
+// draws tile as tile tile_i of output_atlas, using tile_texture of the tile size of context
+// TILIZE_TILE_TODO and TILIZE_TILE_SKIP tiles are drawn black, others are handed to options->tile_callback if options isn't NULL
+static void draw_tile(const tilize_context_t *context, rgb24_atlas_t *output_atlas, const tilize_process_options_t *options, rgb24_texture_t *tile_texture, int tile_i, const tilize_tile_t *tile){
+    const int tile_size = context->tile_width * context->tile_height,
+              tile_x    = tile_i % output_atlas->tile_amount_x,
+              tile_y    = tile_i / output_atlas->tile_amount_x;
+    if(tile->pattern < 0){
+        memset(tile_texture->data, 0, tile_size * sizeof(*tile_texture->data));
+        rgb24_atlas_set_tile(output_atlas, tile_texture, tile_x, tile_y);
+        return;
+    }
+
+    // colorize tile
+    const unsigned char *mask = context->masks + (size_t)tile->pattern * tile_size;
+    for(int j = 0; j < tile_size; ++j){
+        if(mask[j]) tile_texture->data[j] = context->colors[tile->col1];
+        else        tile_texture->data[j] = context->colors[tile->col2];
+    }
+    // hand tile to whoever wants it
+    if(options && options->tile_callback) options->tile_callback(options->user_data, tile_x, tile_y, tile_texture);
+    // save tile to output_atlas
+    rgb24_atlas_set_tile(output_atlas, tile_texture, tile_x, tile_y);
+}
+// creates the search of ctx once everything else about it is known, destroying ctx on failure
+static int create_search(tilize_context_t *ctx){
+    if(search_create(&ctx->search, ctx->tile_width, ctx->tile_height, ctx->num_patterns, ctx->masks,
+                     ctx->num_colors, ctx->colors, ctx->col1_min, ctx->col1_max, ctx->col2_min, ctx->col2_max)){
+        VERRPRINT(0, "Failed to create search");
+        ctx->search = NULL;
+        tilize_context_destroy(ctx);
+        return 1;
+    }
+    return 0;
+}
+// gets the search over a few patterns of context for the first pass of tilize_process() with a deadline into coarse, creating it the first time it's needed
+// coarse is NULL if context doesn't have enough different patterns for it to be any faster
+static int get_coarse(const tilize_context_t *context, search_t **coarse){
+    tilize_context_t *ctx = (tilize_context_t *)context; // coarse is the only thing ever changed, and only atomically
+    *coarse = atomic_load(&ctx->coarse);
+    if(*coarse) return 0;
+    search_t *created  = NULL,
+             *expected = NULL;
+    if(search_create_coarse(&created, context->search, PROGRESSIVE_PATTERNS)){
+        VERRPRINT(0, "Failed to create coarse search");
+        return 1;
+    }
+    if(!created) return 0; // only a few different patterns
+    // another thread might have created one meanwhile, in which case that one is used
+    if(atomic_compare_exchange_strong(&ctx->coarse, &expected, created)) *coarse = created;
+    else{
+        search_destroy(created);
+        *coarse = expected;
+    }
+    return 0;
+}
+// puts the path of the pattern image of tilize_config loaded from config_path into pattern_path
+static void get_pattern_path(char *restrict pattern_path, size_t pattern_path_size, const tilize_config_t *restrict tilize_config, const char *restrict config_path){
+    const size_t pp_len = pattern_path_size - 1;
+    pattern_path[0] = 0;
+    strncpy(pattern_path, config_path, pp_len);
+    pattern_path[pp_len] = 0;
+    char *last_slash = strrchr(pattern_path, '/');
+    if(last_slash == NULL) last_slash = strrchr(pattern_path, '\\'); // retry with '\'
+    if(last_slash == NULL){
+        strncpy(pattern_path, tilize_config->pattern_path, pp_len);
+    }
+    else{
+        ++last_slash;
+        strncpy(last_slash, tilize_config->pattern_path, pp_len - (last_slash - pattern_path));
+    }
+    pattern_path[pp_len] = 0;
+}
+// gets the absolute path of the existing file at path into absolute, so it can be found from any working directory
+static int get_absolute_path(char *restrict absolute, size_t absolute_size, const char *restrict path){
+    #if defined(_WIN32)
+        return _fullpath(absolute, path, absolute_size) ? 0 : 1;
+    #elif defined(__unix__) || defined(__APPLE__)
+        char *resolved = realpath(path, NULL);
+        if(!resolved) return 1;
+        const int too_long = strlen(resolved) >= absolute_size;
+        if(!too_long) strcpy(absolute, resolved);
+        free(resolved);
+        return too_long;
+    #else
+        // no way to know, hope it stays relative to the same directory
+        if(strlen(path) >= absolute_size) return 1;
+        strcpy(absolute, path);
+        return 0;
+    #endif
+}
+// gets the modification time and size of the file at path, returns 1 if it doesn't exist
+static int get_file_stamp(const char *restrict path, uint64_t *restrict mtime, uint64_t *restrict size){
+    struct stat file_stat;
+    if(stat(path, &file_stat)) return 1;
+    *mtime = (uint64_t)file_stat.st_mtime;
+    *size  = (uint64_t)file_stat.st_size;
+    return 0;
+}
+// continues the fnv-1a hash hash (FNV1A_BASIS to start a new one) with size bytes at data
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t size){
+    const unsigned char *bytes = data;
+    for(size_t i = 0; i < size; ++i){
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+// returns whether compiled starts like a compiled configuration
+static int is_compiled(const mapped_file_t *compiled){
+    uint32_t magic;
+    if(compiled->size < sizeof(magic)) return 0;
+    memcpy(&magic, compiled->data, sizeof(magic));
+    return magic == COMPILED_MAGIC;
+}
+// returns whether compiled, which starts like a compiled configuration, is a complete and undamaged one
+static int compiled_valid(const mapped_file_t *compiled){
+    struct compiled_header header;
+    if(compiled->size < sizeof(header)) return 0;
+    memcpy(&header, compiled->data, sizeof(header));
+    if(header.version != COMPILED_VERSION) return 0;
+    if(header.tile_width == 0 || header.tile_height == 0 || header.config_path_length == 0) return 0;
+    if(header.bckg_color < -1 || header.bckg_color >= (int32_t)header.num_colors || header.forg_color < -1 || header.forg_color >= (int32_t)header.num_colors) return 0;
+    const uint64_t body_size = (uint64_t)header.config_path_length + header.pattern_path_length + (uint64_t)header.num_colors * 3 + (uint64_t)header.num_patterns * header.tile_width * header.tile_height;
+    if(compiled->size - sizeof(header) != body_size) return 0;
+    const char *paths = (const char *)compiled->data + sizeof(header);
+    if(paths[header.config_path_length - 1] != 0) return 0;
+    if(header.pattern_path_length && paths[header.config_path_length + header.pattern_path_length - 1] != 0) return 0;
+    return fnv1a(FNV1A_BASIS, compiled->data + sizeof(header), body_size) == header.checksum;
+}
+// returns whether the sources of compiled changed since it was compiled
+// sources that can't be found anymore (say, because only the compiled configuration was shared) don't count as changed
+static int compiled_stale(const mapped_file_t *compiled){
+    struct compiled_header header;
+    memcpy(&header, compiled->data, sizeof(header));
+    const char *config_path  = (const char *)compiled->data + sizeof(header),
+               *pattern_path = config_path + header.config_path_length;
+    uint64_t mtime, size;
+    if(!get_file_stamp(config_path, &mtime, &size) && (mtime != header.config_mtime || size != header.config_size)) return 1;
+    if(header.pattern_path_length && !get_file_stamp(pattern_path, &mtime, &size) && (mtime != header.pattern_mtime || size != header.pattern_size)) return 1;
+    return 0;
+}
+// creates a context from the valid compiled configuration in compiled, which context takes ownership of
+static int context_from_compiled(tilize_context_t **context, mapped_file_t *compiled){
+    // allocate context
+    tilize_context_t *ctx = malloc(sizeof(*ctx));
+    if(!ctx){
+        VERRPRINT(0, "Failed to allocate ctx");
+        unmap_file(compiled);
+        return 1;
+    }
+    struct compiled_header header;
+    memcpy(&header, compiled->data, sizeof(header));
+    ctx->compiled     = *compiled;
+    ctx->search       = NULL;
+    ctx->coarse       = NULL;
+    *compiled         = MAPPED_FILE_NULL;
+    ctx->owned_masks  = NULL;
+    ctx->tile_width   = header.tile_width;
+    ctx->tile_height  = header.tile_height;
+    ctx->num_patterns = header.num_patterns;
+    ctx->num_colors   = header.num_colors;
+
+    // copy colors, masks are used where they are
+    const unsigned char *current = ctx->compiled.data + sizeof(header) + header.config_path_length + header.pattern_path_length;
+    ctx->colors = malloc(ctx->num_colors * sizeof(*ctx->colors));
+    if(!ctx->colors){
+        VERRPRINT(0, "Failed to allocate colors");
+        tilize_context_destroy(ctx);
+        return 1;
+    }
+    for(int i = 0; i < ctx->num_colors; ++i){
+        ctx->colors[i] = RGB24(current[0], current[1], current[2]);
+        current += 3;
+    }
+    ctx->masks = current;
+
+    // get bckg_color and forg_color
+    ctx->col2_min = header.bckg_color != -1 ? header.bckg_color     : 0;
+    ctx->col2_max = header.bckg_color != -1 ? header.bckg_color + 1 : ctx->num_colors;
+    ctx->col1_min = header.forg_color != -1 ? header.forg_color     : 0;
+    ctx->col1_max = header.forg_color != -1 ? header.forg_color + 1 : ctx->num_colors;
+
+    if(create_search(ctx)) return 1;
+    *context = ctx;
+    return 0;
+}
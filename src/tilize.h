@@ -0,0 +1,179 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#ifndef TILIZE_H__
+#define TILIZE_H__
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include "atlas.h"
+#include "configuration.h"
+#include "texture.h"
+#include "tinycthread.h"
+#include "thread_pool.h"
+
+// everything needed to tilize images with one configuration
+// immutable once created, so any amount of threads can use the same context at the same time
+typedef struct tilize_context_t tilize_context_t;
+
+// gets called for every tile once its result is known, from whichever thread computed it
+// {tile_x, tile_y} is the position of the tile in tiles, not pixels
+typedef void (*tilize_tile_callback_t)(void *user_data, int tile_x, int tile_y, const rgb24_texture_t *tile);
+
+// a configuration compiled into a program as constant tables (see `tools/embed.c`)
+typedef struct tilize_builtin_t{
+    const char          *name;
+    int                  tile_width,
+                         tile_height,
+                         num_patterns,
+                         num_colors;
+    const rgb24_t       *colors;
+    const unsigned char *masks;      // tile_width * tile_height bytes per pattern, 1 where the foreground color is used
+    int                  bckg_color, // if == -1, all colors can be used
+                         forg_color; // same as above
+} tilize_builtin_t;
+
+// prefix of config paths naming a builtin configuration, for example `builtin:melody_16`
+#define TILIZE_BUILTIN_PREFIX "builtin:"
+
+// version of the images Tilize produces, bump it with every change that makes the same input and configuration tilize differently
+// (search, dithering, color distance, output encoding, ...), so results stored by older versions (see `cache.h`) aren't used anymore
+#define TILIZE_RESULT_VERSION 1u
+
+// which pattern and colors a tile is drawn with
+typedef struct tilize_tile_t{
+    int32_t pattern, // or one of the TILIZE_TILE_ values below
+            col1,
+            col2;
+} tilize_tile_t;
+
+// pattern of a tile that still has to be searched
+#define TILIZE_TILE_TODO (-1)
+// pattern of a tile that isn't part of the result, it is left black
+#define TILIZE_TILE_SKIP (-2)
+
+// how an image of image_width * image_height pixels gets tilized with a configuration, one tilize_tile_t per tile
+typedef struct tilize_tile_map_t{
+    int            image_width,
+                   image_height,
+                   tile_width,
+                   tile_height,
+                   tile_amount_x,
+                   tile_amount_y;
+    uint32_t       config_hash,   // tilize_context_hash() of the configuration
+                   input_hash;    // tilize_texture_hash() of the image
+    tilize_tile_t *tiles;         // tile_amount_x * tile_amount_y, row by row
+} tilize_tile_map_t;
+
+#define TILIZE_TILE_MAP_NULL ((tilize_tile_map_t){0, 0, 0, 0, 0, 0, 0, 0, NULL})
+
+// a rectangle of pixels
+typedef struct tilize_rect_t{
+    int x,
+        y,
+        width,
+        height;
+} tilize_rect_t;
+
+// options for a single call to tilize_process()
+typedef struct tilize_process_options_t{
+    int                     num_threads;   // including the calling thread, only used if pool is NULL
+    thread_pool_t          *pool;          // if not NULL, used instead of starting num_threads - 1 threads for this call
+    atomic_int             *running;       // if not NULL, processing stops once it is 0
+    tilize_tile_callback_t  tile_callback; // may be NULL
+    void                   *user_data;     // passed to tile_callback
+    int                     deadline_ms;   // if > 0, every tile first gets a quick approximate result, which are then refined (worst first) until this many ms have passed
+    int                     quality;       // if in [1, 100), results may be up to 100 / quality times worse than the best ones in exchange for skipping more (see search_scratch_create())
+                                           // how much worse they actually are is then measured on a sample of tiles and printed
+    const planar_atlas_t   *input_tiles;   // if not NULL, input_texture already split into tiles of the size of the context (see planar_atlas_from_texture()), used instead of splitting it again
+    tilize_tile_map_t      *tile_map;      // if not NULL, made for input_texture and the context (see tilize_tile_map_create()), only its TILIZE_TILE_TODO tiles are searched
+                                           // and their results put into it as soon as they are found, the others are drawn as they are
+    mtx_t                  *tile_map_mtx;  // if not NULL, locked while results are put into tile_map, so another thread can read it while tilizing
+} tilize_process_options_t;
+
+#define TILIZE_PROCESS_OPTIONS_NULL ((tilize_process_options_t){1, NULL, NULL, NULL, NULL, 0, 100, NULL, NULL, NULL})
+
+// creates a context from tilize_config
+// config_path is where tilize_config was loaded from, pattern_path is relative to it; if either is NULL the default pattern is used
+int tilize_context_create(tilize_context_t **context, const tilize_config_t *restrict tilize_config, const char *config_path);
+// loads a context from the file at config_path, which is either a json configuration or one compiled with tilize_context_compile()
+// compiled configurations whose sources changed since compiling are ignored in favor of those sources
+// if config_path starts with TILIZE_BUILTIN_PREFIX, the builtin configuration of that name is used
+// if config_path is NULL the default configuration is used
+int tilize_context_load(tilize_context_t **context, const char *config_path);
+// compiles the json configuration at config_path into output_path, which tilize_context_load() can then load without parsing json or decoding the pattern image
+int tilize_context_compile(const char *config_path, const char *output_path);
+// creates a context from builtin, which has to stay around for as long as the context does
+int tilize_context_from_builtin(tilize_context_t **context, const tilize_builtin_t *builtin);
+// describes context as a builtin configuration, which points into context and so is only valid as long as it is
+void tilize_context_get_builtin(const tilize_context_t *context, tilize_builtin_t *builtin);
+// makes builtins available to tilize_context_load() as `builtin:[name]`, builtins has to stay around for as long as it's used
+void tilize_set_builtins(const tilize_builtin_t *builtins, int num_builtins);
+// destroyes context
+void tilize_context_destroy(tilize_context_t *context);
+
+// gets the size of the tiles context works with
+void tilize_context_tile_size(const tilize_context_t *context, int *tile_width, int *tile_height);
+// gets a hash of everything about context that changes results, to tell whether results were made with the same configuration
+uint32_t tilize_context_hash(const tilize_context_t *context);
+// gets a hash of the size and pixels of texture
+uint32_t tilize_texture_hash(const rgb24_texture_t *texture);
+
+// creates tile_map for tilizing input_texture with context, with every tile being TILIZE_TILE_TODO
+int tilize_tile_map_create(tilize_tile_map_t *tile_map, const tilize_context_t *context, const rgb24_texture_t *input_texture);
+// saves tile_map to the file at path (stdout for "-"), in the byte order of the machine saving it
+int tilize_tile_map_save(const tilize_tile_map_t *tile_map, const char *path);
+// loads tile_map from the file at path (stdin for "-"), saved with tilize_tile_map_save()
+int tilize_tile_map_load(tilize_tile_map_t *tile_map, const char *path);
+// copies the tiles of from that aren't TILIZE_TILE_TODO or TILIZE_TILE_SKIP into tile_map, both have to be made for the same image and configuration
+int tilize_tile_map_merge(tilize_tile_map_t *restrict tile_map, const tilize_tile_map_t *restrict from);
+// destroyes tile_map
+void tilize_tile_map_destroy(tilize_tile_map_t *tile_map);
+// draws tile_map, made with context, into output_texture, which gets created by this function
+int tilize_tile_map_render(const tilize_context_t *context, const tilize_tile_map_t *tile_map, rgb24_texture_t *output_texture);
+// returns whether the file at path starts like a tile map saved with tilize_tile_map_save()
+int tilize_tile_map_is_file(const char *path);
+// sets the pattern of every tile of tile_map that overlaps rect to pattern
+void tilize_tile_map_mark_rect(tilize_tile_map_t *tile_map, tilize_rect_t rect, int32_t pattern);
+// sets the pattern of every tile of tile_map with a pixel that differs between old_texture and new_texture to pattern
+// both have to be the size of the image tile_map was made for
+int tilize_tile_map_mark_changed(tilize_tile_map_t *tile_map, const rgb24_texture_t *old_texture, const rgb24_texture_t *new_texture, int32_t pattern);
+// copies the pixels of every TILIZE_TILE_SKIP tile of tile_map from source_texture into output_texture, both the size of the image tile_map was made for
+void tilize_tile_map_copy_skipped(const tilize_tile_map_t *tile_map, rgb24_texture_t *output_texture, const rgb24_texture_t *source_texture);
+
+// tilizes input_texture into output_texture, which gets created by this function
+// options may be NULL, in which case TILIZE_PROCESS_OPTIONS_NULL is used
+// returns 0 on success (including running out of time with options->deadline_ms, output_texture has the best results found by then), 1 on failure and 2 if cancelled through options->running (output_texture is destroyed then)
+int tilize_process(const tilize_context_t *context, const rgb24_texture_t *restrict input_texture, rgb24_texture_t *restrict output_texture, const tilize_process_options_t *options);
+
+#endif
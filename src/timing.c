@@ -0,0 +1,64 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#include "timing.h"
+
+#include <stdio.h>
+#if defined(_WIN32)
+    #if defined(__MINGW32__)
+        #include <windows.h> // for whatever reason its with a non capital 'W' with mingw, so ig ill say that extra :333
+    #else
+        #include <Windows.h>
+    #endif
+#elif defined(__unix__)
+    #include <time.h>
+#endif
+#include "print.h"
+
+// gets current time in ms
+ms_t current_ms(void){
+    #if defined(_WIN32)
+        return GetTickCount();
+    #elif defined(__unix__)
+        struct timespec ts;
+        if(!timespec_get(&ts, TIME_UTC)){
+            VERRPRINT(0, "Failed to get current time");
+            VPRINT(1, "Please ignore any timing information given after this\n");
+            return 0;
+        }
+        return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+    #else
+        fprintf(stderr, "Warning: current_ms() not supported at compiletime\n");
+        return 0;
+    #endif
+}
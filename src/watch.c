@@ -0,0 +1,282 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#if defined(__linux__)
+    #define _POSIX_C_SOURCE 200809L
+#endif
+#include "watch.h"
+
+#if WATCH_SUPPORTED
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <string.h>
+    #include <errno.h>
+    #include <limits.h>
+    #include <signal.h>
+    #include <stdatomic.h>
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <sys/stat.h>
+    #include <sys/types.h>
+    #include <unistd.h>
+    #include "load_png.h"
+    #include "print.h"
+    #include "texture.h"
+    #include "thread_pool.h"
+    #include "tilize.h"
+    #include "timing.h"
+
+    // a file waiting to be tilized
+    struct watch_entry{
+        char name[NAME_MAX + 1];
+        ms_t ready_ms; // when it has been untouched for long enough
+    };
+
+    // watch state
+    static volatile sig_atomic_t stop_requested;
+    static atomic_int            running; // cleared together with stop_requested, so a file being tilized stops right away
+    static struct watch_entry    queue[WATCH_QUEUE_SIZE]; // oldest first
+    static int                   queue_length;
+
+    // sets stop_requested and clears running
+    static void handle_stop_signal(int signal_number);
+    // queues name, or delays it if it's already queued
+    static void queue_file(const char *name);
+    // returns whether name is an image that can be both read and written
+    static int is_image_name(const char *name);
+    // tilizes the image called name in watch_dir into output_dir
+    static int tilize_file(const char *watch_dir, const char *output_dir, const char *name, const tilize_context_t *context, thread_pool_t *pool, atomic_int *running);
+
+    // tilizes every image written to or moved into watch_dir into a file of the same name in output_dir until interrupted
+    // config_path is the configuration to use, the default one if NULL
+    int watch_run(const char *watch_dir, const char *output_dir, const char *config_path, int num_threads){
+        int retcode = 0;
+
+        // signals
+        struct sigaction stop_action;
+        memset(&stop_action, 0, sizeof(stop_action));
+        stop_action.sa_handler = &handle_stop_signal; // no SA_RESTART so poll() gets interrupted
+        sigemptyset(&stop_action.sa_mask);
+        sigaction(SIGINT, &stop_action, NULL);
+        sigaction(SIGTERM, &stop_action, NULL);
+        stop_requested = 0;
+        queue_length   = 0;
+        atomic_store(&running, 1);
+
+        // check directories, output_dir being watch_dir would tilize results again and again
+        struct stat watch_stat,
+                    output_stat;
+        if(stat(watch_dir, &watch_stat) || !S_ISDIR(watch_stat.st_mode)){
+            VERRPRINTF(0, "%s is not a directory", watch_dir);
+            return 1;
+        }
+        if(stat(output_dir, &output_stat)){
+            if(mkdir(output_dir, 0777) || stat(output_dir, &output_stat)){
+                VERRPRINTF(0, "Failed to create %s (%s)", output_dir, strerror(errno));
+                return 1;
+            }
+        }
+        if(!S_ISDIR(output_stat.st_mode)){
+            VERRPRINTF(0, "%s is not a directory", output_dir);
+            return 1;
+        }
+        if(watch_stat.st_dev == output_stat.st_dev && watch_stat.st_ino == output_stat.st_ino){
+            VERRPRINT(0, "The output directory has to differ from the watched one");
+            return 1;
+        }
+
+        // set up tilizing once for all files
+        tilize_context_t *context;
+        if(tilize_context_load(&context, config_path)){
+            VERRPRINT(0, "Failed to load context");
+            return 1;
+        }
+        thread_pool_t *pool;
+        if(thread_pool_create(&pool, num_threads - 1)){
+            VERRPRINT(0, "Failed to create pool");
+            tilize_context_destroy(context);
+            return 1;
+        }
+
+        // start watching
+        int inotify_fd = inotify_init();
+        if(inotify_fd < 0){
+            VERRPRINTF(0, "Failed to initialize inotify (%s)", strerror(errno));
+            retcode = 1;
+            goto _clean_and_exit;
+        }
+        if(inotify_add_watch(inotify_fd, watch_dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0){
+            VERRPRINTF(0, "Failed to watch %s (%s)", watch_dir, strerror(errno));
+            retcode = 1;
+            goto _clean_and_exit;
+        }
+        VPRINTF(1, "Watching %s, results go to %s, press Ctrl+C to stop\n", watch_dir, output_dir);
+
+        // handle events until stopped
+        _Alignas(struct inotify_event) char event_buffer[4096];
+        while(!stop_requested){
+            // tilize everything that's ready, checking for new events in between
+            const ms_t now = current_ms();
+            int timeout = -1;
+            for(int i = 0; i < queue_length; ++i){
+                if(queue[i].ready_ms <= now){
+                    struct watch_entry entry = queue[i];
+                    memmove(&queue[i], &queue[i + 1], (queue_length - i - 1) * sizeof(*queue));
+                    --queue_length;
+                    tilize_file(watch_dir, output_dir, entry.name, context, pool, &running);
+                    timeout = 0;
+                    break;
+                }
+                const int wait_ms = (int)(queue[i].ready_ms - now);
+                if(timeout == -1 || wait_ms < timeout) timeout = wait_ms;
+            }
+
+            // wait for events
+            struct pollfd poll_fd;
+            poll_fd.fd     = inotify_fd;
+            poll_fd.events = POLLIN;
+            const int poll_ret = poll(&poll_fd, 1, timeout);
+            if(poll_ret < 0){
+                if(errno == EINTR) continue;
+                VERRPRINTF(0, "Failed to poll inotify_fd (%s)", strerror(errno));
+                retcode = 1;
+                break;
+            }
+            if(poll_ret == 0) continue;
+
+            // read events
+            const ssize_t length = read(inotify_fd, event_buffer, sizeof(event_buffer));
+            if(length < 0){
+                if(errno == EINTR || errno == EAGAIN) continue;
+                VERRPRINTF(0, "Failed to read inotify_fd (%s)", strerror(errno));
+                retcode = 1;
+                break;
+            }
+            for(char *current = event_buffer; current < event_buffer + length; ){
+                const struct inotify_event *event = (const struct inotify_event *)current;
+                current += sizeof(*event) + event->len;
+                if(event->mask & IN_Q_OVERFLOW) VPRINT(1, "Warning: Too many files at once, some were missed\n");
+                if(event->len == 0 || (event->mask & IN_ISDIR)) continue;
+                if(!is_image_name(event->name)) continue;
+                queue_file(event->name);
+            }
+        }
+        VPRINT(1, "Stopping watch\n");
+
+        // clean and exit
+        _clean_and_exit:;
+        if(inotify_fd >= 0) close(inotify_fd);
+        thread_pool_destroy(pool);
+        tilize_context_destroy(context);
+        return retcode;
+    }
+
+    // sets stop_requested and clears running
+    static void handle_stop_signal(int signal_number){
+        (void)signal_number;
+        stop_requested = 1;
+        atomic_store(&running, 0);
+    }
+    // queues name, or delays it if it's already queued
+    static void queue_file(const char *name){
+        const ms_t ready_ms = current_ms() + WATCH_DEBOUNCE_MS;
+        for(int i = 0; i < queue_length; ++i){
+            if(!strcmp(queue[i].name, name)){
+                queue[i].ready_ms = ready_ms;
+                return;
+            }
+        }
+        if(queue_length >= WATCH_QUEUE_SIZE){
+            VPRINTF(1, "Warning: Too many files waiting, skipping %s\n", name);
+            return;
+        }
+        strncpy(queue[queue_length].name, name, NAME_MAX);
+        queue[queue_length].name[NAME_MAX] = 0;
+        queue[queue_length].ready_ms = ready_ms;
+        ++queue_length;
+    }
+    // returns whether name is an image that can be both read and written
+    static int is_image_name(const char *name){
+        if(name[0] == '.') return 0; // hidden or temporary
+        const char *extension = strrchr(name, '.');
+        if(!extension) return 0;
+        return !strcmp(extension, ".png") || !strcmp(extension, ".jpg") || !strcmp(extension, ".jpeg") || !strcmp(extension, ".bmp") ||
+               !strcmp(extension, ".ppm") || !strcmp(extension, ".pam") || !strcmp(extension, ".qoi");
+    }
+    // tilizes the image called name in watch_dir into output_dir
+    static int tilize_file(const char *watch_dir, const char *output_dir, const char *name, const tilize_context_t *context, thread_pool_t *pool, atomic_int *running){
+        char input_path[PATH_MAX],
+             output_path[PATH_MAX];
+        if(snprintf(input_path, sizeof(input_path), "%s/%s", watch_dir, name) >= (int)sizeof(input_path) ||
+           snprintf(output_path, sizeof(output_path), "%s/%s", output_dir, name) >= (int)sizeof(output_path)){
+            VERRPRINTF(0, "Path of %s is too long", name);
+            return 1;
+        }
+        const ms_t start_ms = current_ms();
+
+        // load, tilize and save
+        rgb24_texture_t input_texture = RGB24_TEXTURE_NULL;
+        if(load_png_owned(&input_texture, input_path)){ // artists might write the file again while it's tilized
+            VERRPRINTF(0, "Failed to load %s", input_path);
+            return 1;
+        }
+        rgb24_texture_t output_texture = RGB24_TEXTURE_NULL;
+        tilize_process_options_t options = TILIZE_PROCESS_OPTIONS_NULL;
+        options.pool    = pool;
+        options.running = running;
+        const int ret_code = tilize_process(context, &input_texture, &output_texture, &options);
+        rgb24_texture_destroy(&input_texture);
+        if(ret_code){
+            if(ret_code == 1) VERRPRINTF(0, "Failed to tilize %s", input_path);
+            return ret_code;
+        }
+        if(save_png(output_path, &output_texture)){
+            VERRPRINTF(0, "Failed to save %s", output_path);
+            rgb24_texture_destroy(&output_texture);
+            return 1;
+        }
+        rgb24_texture_destroy(&output_texture);
+
+        VPRINTF(2, "Tilized %s in %llu ms\n", name, (long long unsigned)(current_ms() - start_ms));
+        return 0;
+    }
+#else
+    #include <stdio.h>
+
+    // dummy implementation to give warnings
+    int watch_run(const char *watch_dir, const char *output_dir, const char *config_path, int num_threads){
+        fprintf(stderr, "Warning: watch_run() not supported at compiletime\n");
+        int a = watch_dir[0] + output_dir[0] + (config_path != NULL) + num_threads; a = a + a; // to keep out some warnings
+        return 1;
+    }
+#endif
@@ -0,0 +1,58 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+#ifndef WATCH_H__
+#define WATCH_H__
+
+#ifndef WATCH_SUPPORTED
+    #if defined(__linux__)
+        #define WATCH_SUPPORTED 1
+    #else
+        #define WATCH_SUPPORTED 0
+    #endif
+#endif
+
+// maximum amount of files waiting to be tilized, any more are dropped with a warning
+#ifndef WATCH_QUEUE_SIZE
+    #define WATCH_QUEUE_SIZE 256
+#endif
+// time a file has to stay untouched before it is tilized, so files written multiple times are only tilized once
+#ifndef WATCH_DEBOUNCE_MS
+    #define WATCH_DEBOUNCE_MS 100
+#endif
+
+// tilizes every image written to or moved into watch_dir into a file of the same name in output_dir until interrupted
+// config_path is the configuration to use, the default one if NULL
+int watch_run(const char *watch_dir, const char *output_dir, const char *config_path, int num_threads);
+
+#endif
@@ -0,0 +1,230 @@
+/************************************************\
+| MIT License                                    |
+|                                                |
+| Copyright (c) 2024 rue04                       |
+|                                                |
+| Permission is hereby granted, free of charge,  |
+| to any person obtaining a copy of this         |
+| software and associated documentation files    |
+| (the "Software"), to deal in the Software      |
+| without restriction, including without         |
+| limitation the rights to use, copy, modify,    |
+| merge, publish, distribute, sublicense, and/or |
+| sell copies of the Software, and to permit     |
+| persons to whom the Software is furnished to   |
+| do so, subject to the following conditions:    |
+|                                                |
+| The above copyright notice and this permission |
+| notice shall be included in all copies or      |
+| substantial portions of the Software.          |
+|                                                |
+| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT      |
+| WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,      |
+| INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF |
+| MERCHANTABILITY, FITNESS FOR A PARTICULAR      |
+| PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL |
+| THE AUTHORS OR COPYRIGHT HILDERS BE LIABLE FOR |
+| ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER |
+| IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   |
+| ARISING FROM, OUT OF OR IN CONNECTION WITH THE |
+| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   |
+| SOFTWARE.                                      |
+\************************************************/
+
+// turns configurations into constant tables that can be compiled into Tilize, so using them needs no file io or decoding
+// usage: TilizeEmbed [output.c] [config.json]...
+// output.c is only written if its contents changed, so it doesn't get recompiled every build
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include "print.h"
+#include "tilize.h"
+
+// text being generated
+struct text{
+    char  *data;
+    size_t length,
+           capacity;
+};
+
+// appends formatted text to text
+static int append(struct text *text, const char *format, ...);
+// appends the tables for the configuration at config_path to text as number index, and its entry in builtin_configs to entries
+static int append_config(struct text *text, struct text *entries, const char *config_path, int index);
+// gets the name of the configuration at config_path (its file name without `.json`) into name
+static void get_name(char *restrict name, size_t name_size, const char *restrict config_path);
+// writes text to path, unless that already contains it
+static int write_if_changed(const struct text *text, const char *path);
+
+int main(int argc, const char **argv){
+    if(argc < 3){
+        printf("Usage: %s [output.c] [config.json]...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    int return_code = EXIT_SUCCESS;
+    struct text text    = {NULL, 0, 0},
+                entries = {NULL, 0, 0};
+
+    // tables
+    if(append(&text, "// generated by TilizeEmbed (tools/embed.c), changes will be overwritten\n\n#include \"builtin_configs.h\"\n")){
+        return_code = EXIT_FAILURE;
+        goto _clean_and_exit;
+    }
+    for(int i = 2; i < argc; ++i){
+        if(append_config(&text, &entries, argv[i], i - 2)){
+            fprintf(stderr, "Failed to embed %s\n", argv[i]);
+            return_code = EXIT_FAILURE;
+            goto _clean_and_exit;
+        }
+    }
+
+    // list of configurations
+    if(append(&text, "\nconst tilize_builtin_t builtin_configs[] = {\n%s};\nconst int num_builtin_configs = %i;\n", entries.data, argc - 2)){
+        return_code = EXIT_FAILURE;
+        goto _clean_and_exit;
+    }
+
+    // write it
+    if(write_if_changed(&text, argv[1])){
+        fprintf(stderr, "Failed to write %s\n", argv[1]);
+        return_code = EXIT_FAILURE;
+    }
+
+    // clean and exit
+    _clean_and_exit:;
+    free(text.data);
+    free(entries.data);
+    return return_code;
+}
+
+// appends formatted text to text
+static int append(struct text *text, const char *format, ...){
+    va_list args;
+    va_start(args, format);
+    const int length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    if(length < 0){
+        VERRPRINT(0, "Failed to format text");
+        return 1;
+    }
+    if(text->length + length + 1 > text->capacity){
+        size_t new_capacity = text->capacity ? text->capacity * 2 : 4096;
+        while(text->length + length + 1 > new_capacity) new_capacity *= 2;
+        char *new_data = realloc(text->data, new_capacity);
+        if(!new_data){
+            VERRPRINT(0, "Failed to reallocate text");
+            return 1;
+        }
+        text->data     = new_data;
+        text->capacity = new_capacity;
+    }
+    va_start(args, format);
+    vsnprintf(text->data + text->length, length + 1, format, args);
+    va_end(args);
+    text->length += length;
+    return 0;
+}
+// appends the tables for the configuration at config_path to text as number index, and its entry in builtin_configs to entries
+static int append_config(struct text *text, struct text *entries, const char *config_path, int index){
+    tilize_context_t *context;
+    if(tilize_context_load(&context, config_path)){
+        VERRPRINT(0, "Failed to load context");
+        return 1;
+    }
+    tilize_builtin_t builtin;
+    tilize_context_get_builtin(context, &builtin);
+    char name[256];
+    get_name(name, sizeof(name), config_path);
+    int retcode = 0;
+
+    // colors
+    if(append(text, "\n// %s\nstatic const rgb24_t colors_%i[] = {\n", name, index)){
+        retcode = 1;
+        goto _clean_and_exit;
+    }
+    for(int i = 0; i < builtin.num_colors; ++i){
+        if(append(text, "    {0x%02x, 0x%02x, 0x%02x},\n", builtin.colors[i].r, builtin.colors[i].g, builtin.colors[i].b)){
+            retcode = 1;
+            goto _clean_and_exit;
+        }
+    }
+
+    // masks, one line per pattern
+    if(append(text, "};\nstatic const unsigned char masks_%i[] = {\n", index)){
+        retcode = 1;
+        goto _clean_and_exit;
+    }
+    const int tile_size = builtin.tile_width * builtin.tile_height;
+    for(int pt_i = 0; pt_i < builtin.num_patterns; ++pt_i){
+        if(append(text, "   ")){
+            retcode = 1;
+            goto _clean_and_exit;
+        }
+        for(int i = 0; i < tile_size; ++i){
+            if(append(text, " %i,", builtin.masks[pt_i * tile_size + i])){
+                retcode = 1;
+                goto _clean_and_exit;
+            }
+        }
+        if(append(text, "\n")){
+            retcode = 1;
+            goto _clean_and_exit;
+        }
+    }
+
+    // entry in builtin_configs
+    if(append(text, "};\n") ||
+       append(entries, "    {\"%s\", %i, %i, %i, %i, colors_%i, masks_%i, %i, %i},\n", name,
+              builtin.tile_width, builtin.tile_height, builtin.num_patterns, builtin.num_colors, index, index, builtin.bckg_color, builtin.forg_color)){
+        retcode = 1;
+        goto _clean_and_exit;
+    }
+
+    // clean and exit
+    _clean_and_exit:;
+    tilize_context_destroy(context);
+    return retcode;
+}
+// gets the name of the configuration at config_path (its file name without `.json`) into name
+static void get_name(char *restrict name, size_t name_size, const char *restrict config_path){
+    const char *last_slash = strrchr(config_path, '/');
+    if(!last_slash) last_slash = strrchr(config_path, '\\'); // retry with '\'
+    const char *file_name = last_slash ? last_slash + 1 : config_path;
+    strncpy(name, file_name, name_size - 1);
+    name[name_size - 1] = 0;
+    char *extension = strrchr(name, '.');
+    if(extension && !strcmp(extension, ".json")) *extension = 0;
+}
+// writes text to path, unless that already contains it
+static int write_if_changed(const struct text *text, const char *path){
+    // compare with what's there
+    FILE *f = fopen(path, "rb");
+    if(f){
+        int same = 1;
+        for(size_t i = 0; i < text->length && same; ++i){
+            if(fgetc(f) != (unsigned char)text->data[i]) same = 0;
+        }
+        if(same && fgetc(f) != EOF) same = 0;
+        fclose(f);
+        if(same) return 0;
+    }
+
+    // write
+    f = fopen(path, "wb");
+    if(!f){
+        VERRPRINTF(0, "Failed to open %s", path);
+        return 1;
+    }
+    if(fwrite(text->data, 1, text->length, f) != text->length){
+        VERRPRINTF(0, "Failed to write to %s", path);
+        fclose(f);
+        return 1;
+    }
+    if(fclose(f)){
+        VERRPRINTF(0, "Failed to close %s", path);
+        return 1;
+    }
+    return 0;
+}
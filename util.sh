@@ -23,7 +23,7 @@ if [ -z "$1" ] || [ "$1" = "help" ] || [ "$1" = "--help" ] || [ "$1" = "-h" ]; t
         echo "$0 make all            | Builds all configurations"
     elif [ "$2" = "clean" ]; then
         # clean help message
-        echo "$0 clean binaries      | Remove binaries and object files"
+        echo "$0 clean binaries      | Remove binaries, object files and generated sources"
         echo "$0 clean premake       | Remove files generated by premake"
         echo "$0 clean dependencies  | Remove downloaded dependencies"
         echo "$0 clean build         | Remove binaries, objects and premake files"
@@ -82,15 +82,15 @@ if [ "$1" = "clean" ]; then
     }
 
     if [ -z "$2" ] || [ "$2" = "binaries" ] || [ "$2" = "bin" ]; then
-        delete_files bin obj
+        delete_files bin obj src/builtin_configs.c
     elif [ "$2" = "premake" ]; then
-        delete_files Makefile Tilize.make
+        delete_files Makefile Tilize.make TilizeEmbed.make libtilize.make
     elif [ "$2" = "dependencies" ] || [ "$2" = "dep" ]; then
         delete_files src/cJSON.* src/tinycthread.* src/stb*.h
     elif [ "$2" = "build" ]; then
-        delete_files bin obj Makefile Tilize.make
+        delete_files bin obj src/builtin_configs.c Makefile Tilize.make TilizeEmbed.make libtilize.make
     elif [ "$2" = "all" ]; then
-        delete_files bin obj Makefile Tilize.make src/cJSON.* src/tinycthread.* src/stb*.h
+        delete_files bin obj src/builtin_configs.c Makefile Tilize.make TilizeEmbed.make libtilize.make src/cJSON.* src/tinycthread.* src/stb*.h
     fi
     exit 0
 fi